@@ -0,0 +1,194 @@
+//
+// CoCoChain Core Microbenchmarks
+//
+
+#include <benchmark/benchmark.h>
+#include <cmath>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include "ConceptStorage.h"
+#include "GossipQuorum.h"
+#include "SemanticVerifier.h"
+#include "TransactionId.h"
+#include "VerificationCache.h"
+#include "VoteTable.h"
+
+namespace {
+
+// Zero-mean, unit-scale vectors like the ones CoCoChainApp generates
+ConceptStorage makeConceptVector(size_t dims, std::mt19937& rng)
+{
+    std::uniform_real_distribution<double> dist(-1.0, 1.0);
+    ConceptStorage data;
+    data.resize(dims);
+    for (auto& value : data) value = dist(rng);
+    return data;
+}
+
+void BM_Digest(benchmark::State& state, DigestAlgorithm algorithm)
+{
+    std::mt19937 rng(42);
+    ConceptStorage data = makeConceptVector(state.range(0), rng);
+    SemanticVerifier verifier(true, 2.0, 0, algorithm);
+    for (auto _ : state)
+        benchmark::DoNotOptimize(verifier.digest(data));
+    state.SetItemsProcessed(state.iterations());
+    state.SetBytesProcessed(state.iterations() * data.size() * sizeof(ConceptScalar));
+}
+
+void BM_Verify(benchmark::State& state, DigestAlgorithm algorithm)
+{
+    std::mt19937 rng(42);
+    ConceptStorage data = makeConceptVector(state.range(0), rng);
+    SemanticVerifier verifier(true, 2.0, 0, algorithm);
+    SemanticDigest digest = verifier.digest(data);
+    for (auto _ : state)
+        benchmark::DoNotOptimize(verifier.verify(data, digest));
+    state.SetItemsProcessed(state.iterations());
+}
+
+// range(1) vectors of range(0) dimensions verified per iteration, one at a
+// time from separate buffers or together from one structure-of-arrays batch
+void BM_VerifyEach(benchmark::State& state)
+{
+    std::mt19937 rng(42);
+    SemanticVerifier verifier;
+    std::vector<ConceptStorage> vectors;
+    std::vector<SemanticDigest> digests;
+    for (int i = 0; i < state.range(1); i++) {
+        vectors.push_back(makeConceptVector(state.range(0), rng));
+        digests.push_back(verifier.digest(vectors.back()));
+    }
+    for (auto _ : state) {
+        for (size_t i = 0; i < vectors.size(); i++)
+            benchmark::DoNotOptimize(verifier.verify(vectors[i], digests[i]));
+    }
+    state.SetItemsProcessed(state.iterations() * vectors.size());
+}
+
+void BM_VerifyBatch(benchmark::State& state)
+{
+    std::mt19937 rng(42);
+    SemanticVerifier verifier;
+    std::vector<ConceptStorage> vectors;
+    for (int i = 0; i < state.range(1); i++) vectors.push_back(makeConceptVector(state.range(0), rng));
+    ConceptBatch batch;
+    for (const ConceptStorage& data : vectors) batch.add(data, verifier.digest(data));
+    std::vector<uint8_t> verdicts;
+    for (auto _ : state) {
+        verifier.verifyBatch(batch, verdicts);
+        benchmark::DoNotOptimize(verdicts.data());
+    }
+    state.SetItemsProcessed(state.iterations() * batch.size());
+}
+
+// The app's cached verification of range(0)-dimension vectors: the key is
+// the fast payload fingerprint plus the claimed digest, and a miss verifies
+// (reusing the fingerprint as the fast digest) and inserts. Hits cycle over
+// a warm cache; misses cycle over more vectors than a one-slot cache holds.
+void BM_VerifyCache(benchmark::State& state, DigestAlgorithm algorithm, bool hit)
+{
+    std::mt19937 rng(42);
+    SemanticVerifier verifier(true, 2.0, 0, algorithm);
+    std::vector<ConceptStorage> vectors;
+    std::vector<SemanticDigest> digests;
+    for (int i = 0; i < 64; i++) {
+        vectors.push_back(makeConceptVector(state.range(0), rng));
+        digests.push_back(verifier.digest(vectors.back()));
+    }
+    VerificationCache cache;
+    cache.resize(hit ? 65536 : 1);
+    if (hit) {
+        for (size_t i = 0; i < vectors.size(); i++)
+            cache.insert(VerificationCache::keyOf(computeFastDigest(vectors[i].data(), vectors[i].size()), digests[i]), true);
+    }
+    size_t next = 0;
+    for (auto _ : state) {
+        const ConceptStorage& data = vectors[next];
+        SemanticDigest fingerprint = computeFastDigest(data.data(), data.size());
+        uint64_t key = VerificationCache::keyOf(fingerprint, digests[next]);
+        int verdict = cache.lookup(key);
+        if (verdict < 0) {
+            SemanticDigest computed = algorithm == DigestAlgorithm::FAST ? fingerprint : verifier.digest(data);
+            verdict = computed == digests[next] && verifier.checkStatistics(data);
+            cache.insert(key, verdict);
+        }
+        benchmark::DoNotOptimize(verdict);
+        next = (next + 1) % vectors.size();
+    }
+    state.SetItemsProcessed(state.iterations());
+    state.counters["hitRate"] = cache.getHits() / (double)state.iterations();
+}
+
+// Vote stream for range(0) live transactions, each voted on by range(1)
+// nodes in interleaved order, with a 2/3 quorum. Tallies are dropped at
+// quorum and late votes reopen them, as in the engines.
+void BM_VoteTally(benchmark::State& state)
+{
+    int numTransactions = state.range(0);
+    int numVoters = state.range(1);
+    int requiredVotes = (numVoters * 2 + 2) / 3;
+    std::vector<uint64_t> txIds;
+    for (int i = 0; i < numTransactions; i++) txIds.push_back(makeTransactionId(i % numVoters, i));
+
+    VoteTable table;
+    table.reserve(numTransactions);
+    uint64_t now = 0;
+    for (auto _ : state) {
+        for (int voter = 0; voter < numVoters; voter++) {
+            for (uint64_t txId : txIds) {
+                auto entry = table.open(txId, numVoters, now);
+                if (entry.second) entry.first->setRequiredVotes(requiredVotes);
+                if (entry.first->addVote(voter, true) && entry.first->hasQuorum())
+                    table.drop(txId);
+            }
+        }
+        now++;
+    }
+    state.SetItemsProcessed(state.iterations() * numTransactions * numVoters);
+    state.counters["blocksAndRehashes"] = table.getAllocationCount();
+}
+
+// Voting on one honest transaction among range(0) neighbours, 10% of them
+// adversarial and rejecting, with the default bftThreshold, minimum quorum
+// and gossip coverage. The confirmRate counter is the share of
+// transactions reaching quorum; gossip should match broadcast.
+void BM_QuorumConfirmation(benchmark::State& state, bool gossip)
+{
+    int n = state.range(0);
+    const double bftThreshold = 0.67, honestFraction = 0.9, coverage = 0.99;
+    const int minQuorum = 3;
+    int bftQuorum = std::max(minQuorum, static_cast<int>(std::ceil(n * bftThreshold)));
+    double p = gossip ? GossipQuorum::voteProbability(n, coverage, bftQuorum, minQuorum) : 1.0;
+    int required = gossip ? GossipQuorum::quorum(p, bftQuorum, minQuorum) : bftQuorum;
+
+    std::mt19937 rng(42);
+    std::binomial_distribution<int> acceptVotes(n, p * honestFraction);
+    int64_t confirmed = 0;
+    for (auto _ : state) {
+        if (acceptVotes(rng) >= required) confirmed++;
+    }
+    state.counters["quorum"] = required;
+    state.counters["expectedVoters"] = n * p;
+    state.counters["confirmRate"] = confirmed / (double)state.iterations();
+}
+
+} // namespace
+
+BENCHMARK_CAPTURE(BM_Digest, fast, DigestAlgorithm::FAST)->Arg(10)->Arg(64)->Arg(256);
+BENCHMARK_CAPTURE(BM_Digest, sha256, DigestAlgorithm::SHA256)->Arg(10)->Arg(64)->Arg(256);
+BENCHMARK_CAPTURE(BM_Verify, fast, DigestAlgorithm::FAST)->Arg(10)->Arg(64)->Arg(256);
+BENCHMARK_CAPTURE(BM_Verify, sha256, DigestAlgorithm::SHA256)->Arg(10)->Arg(64)->Arg(256);
+BENCHMARK_CAPTURE(BM_VerifyCache, fast_hit, DigestAlgorithm::FAST, true)->Arg(64);
+BENCHMARK_CAPTURE(BM_VerifyCache, fast_miss, DigestAlgorithm::FAST, false)->Arg(64);
+BENCHMARK_CAPTURE(BM_VerifyCache, sha256_hit, DigestAlgorithm::SHA256, true)->Arg(64);
+BENCHMARK_CAPTURE(BM_VerifyCache, sha256_miss, DigestAlgorithm::SHA256, false)->Arg(64);
+BENCHMARK(BM_VerifyEach)->Args({10, 32})->Args({64, 32});
+BENCHMARK(BM_VerifyBatch)->Args({10, 32})->Args({64, 32});
+BENCHMARK_CAPTURE(BM_QuorumConfirmation, broadcast, false)->Arg(20)->Arg(50)->Arg(200)->Arg(1000);
+BENCHMARK_CAPTURE(BM_QuorumConfirmation, gossip, true)->Arg(20)->Arg(50)->Arg(200)->Arg(1000);
+BENCHMARK(BM_VoteTally)->Args({64, 50})->Args({512, 200})->Args({2048, 500});
+
+BENCHMARK_MAIN();
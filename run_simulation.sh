@@ -4,7 +4,6 @@
 #
 
 echo "Building CoCoChain simulation..."
-make clean
 make
 
 if [ $? -ne 0 ]; then
@@ -15,16 +14,16 @@ fi
 echo "Creating results directory..."
 mkdir -p results
 
-echo "Running simulation with 10 random seeds..."
-cd simulations
+echo "Running simulation with 10 random seeds in parallel..."
+python3 scripts/run_sweep.py --repetitions 10
 
-for seed in {0..9}; do
-    echo "Running simulation with seed $seed..."
-    ../CoCoChain -u Cmdenv -c General --seed-set=$seed --result-dir=../results
-done
+if [ $? -ne 0 ]; then
+    echo "Some runs failed. Exiting."
+    exit 1
+fi
 
 echo "Analyzing results..."
-cd ../scripts
+cd scripts
 python3 analyze_results.py
 
 echo "Simulation complete. Check results directory for output files."
\ No newline at end of file
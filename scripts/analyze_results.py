@@ -7,6 +7,7 @@ Processes simulation results and generates table format for research paper
 import os
 import sys
 import glob
+import shlex
 import pandas as pd
 import numpy as np
 from pathlib import Path
@@ -20,7 +21,8 @@ def parse_scalar_file(filepath):
             for line in f:
                 line = line.strip()
                 if line.startswith('scalar'):
-                    parts = line.split()
+                    # Names with spaces are quoted
+                    parts = shlex.split(line)
                     if len(parts) >= 4:
                         module = parts[1]
                         metric = parts[2]
@@ -69,6 +71,41 @@ def parse_vector_file(filepath):
     
     return vectors
 
+def parse_histogram_bins(filepath, statistic):
+    """Sum the bins of one histogram statistic over all modules of a file"""
+    bins = {}
+    in_statistic = False
+    
+    try:
+        with open(filepath, 'r') as f:
+            for line in f:
+                parts = line.split()
+                if not parts:
+                    continue
+                if parts[0] in ('statistic', 'scalar', 'vector', 'run'):
+                    in_statistic = parts[0] == 'statistic' and len(parts) >= 3 and parts[2] == statistic
+                elif in_statistic and parts[0] == 'bin' and len(parts) >= 3:
+                    lower = float(parts[1])
+                    bins[lower] = bins.get(lower, 0) + float(parts[2])
+    except Exception as e:
+        print(f"Error parsing {filepath}: {e}")
+    
+    return bins
+
+def histogram_quantile(bins, q):
+    """Quantile of merged log-histogram bins (midpoint of the bin holding it)"""
+    edges = sorted(lower for lower in bins if np.isfinite(lower))
+    total = sum(bins[lower] for lower in edges)
+    if total == 0:
+        return None
+    seen = 0
+    for i, lower in enumerate(edges):
+        seen += bins[lower]
+        if seen >= q * total:
+            upper = edges[i + 1] if i + 1 < len(edges) else lower
+            return 0.5 * (lower + upper)
+    return edges[-1]
+
 def analyze_results():
     """Analyze simulation results and generate summary table"""
     
@@ -101,6 +138,18 @@ def analyze_results():
         overhead_total = 0
         malformed_total = 0
         
+        # Runs with a CoCoChainCollector carry one network-wide record
+        collectors = [m for m in results if m.endswith('.collector') and 'Messages received' in results[m]]
+        if collectors:
+            metrics = results[collectors[0]]
+            results = {collectors[0]: {
+                'endToEndLatency:mean': metrics.get('endToEndLatency:mean'),
+                'consensusOverhead:sum': metrics['Messages received'],
+                'malformedDetected:sum': metrics.get('Malformed detected', 0),
+            }}
+            if results[collectors[0]]['endToEndLatency:mean'] is None:
+                del results[collectors[0]]['endToEndLatency:mean']
+        
         for module, metrics in results.items():
             if 'endToEndLatency:mean' in metrics:
                 latency_values.append(metrics['endToEndLatency:mean'])
@@ -124,6 +173,14 @@ def analyze_results():
             'malformed_detected': malformed_total
         })
     
+    # Network-wide latency quantiles from the merged "loghistogram" bins
+    latency_bins = {}
+    for scalar_file in scalar_files:
+        for lower, count in parse_histogram_bins(scalar_file, 'endToEndLatency:loghistogram').items():
+            latency_bins[lower] = latency_bins.get(lower, 0) + count
+    latency_p50 = histogram_quantile(latency_bins, 0.5)
+    latency_p99 = histogram_quantile(latency_bins, 0.99)
+    
     # Calculate statistics
     if all_latencies:
         latency_mean = np.mean(all_latencies)
@@ -154,6 +211,8 @@ def analyze_results():
     print(f"{'Metric':<35} {'Mean':<15} {'Std Dev':<15}")
     print("-" * 65)
     print(f"{'End-to-end latency (s)':<35} {latency_mean:<15.4f} {latency_std:<15.4f}")
+    if latency_p99 is not None:
+        print(f"{'End-to-end latency p50 / p99 (s)':<35} {latency_p50:<15.4f} {latency_p99:<15.4f}")
     print(f"{'Consensus overhead (msgs)':<35} {overhead_mean:<15.2f} {overhead_std:<15.2f}")
     print(f"{'Malformed detected (count)':<35} {malformed_mean:<15.2f} {malformed_std:<15.2f}")
     
@@ -0,0 +1,177 @@
+#!/usr/bin/env python3
+"""
+CoCoChain Scaling Benchmark
+Runs the fixed-seed [Config Benchmark] scenarios one at a time and writes
+events/sec, wall-clock time, peak RSS and consensus overhead per confirmed
+transaction as JSON
+"""
+
+import os
+import re
+import sys
+import json
+import time
+import glob
+import shutil
+import socket
+import argparse
+import subprocess
+from pathlib import Path
+
+SCRIPT_DIR = Path(__file__).resolve().parent
+REPO_DIR = SCRIPT_DIR.parent
+SIMULATIONS_DIR = REPO_DIR / "simulations"
+
+# Metrics compared against a baseline: name -> True if higher is better
+TRACKED_METRICS = {
+    'events_per_sec': True,
+    'peak_rss_kb': False,
+    'overhead_per_confirmed': False,
+}
+
+EVENT_PATTERN = re.compile(r'event #(\d+)')
+
+def parse_arguments():
+    """Parse command-line options"""
+    parser = argparse.ArgumentParser(description="Run the CoCoChain scaling benchmarks")
+    parser.add_argument('--config', default='Benchmark',
+                        help="omnetpp.ini configuration holding the scenarios")
+    parser.add_argument('--runs', type=int, nargs='+',
+                        help="run numbers to execute (default: all runs of the config)")
+    parser.add_argument('--binary', default=str(REPO_DIR / "CoCoChain"),
+                        help="simulation executable")
+    parser.add_argument('--result-dir', default=str(REPO_DIR / "results" / "benchmark"),
+                        help="scratch directory for the runs' result files")
+    parser.add_argument('--output', default=str(REPO_DIR / "benchmark_results.json"),
+                        help="JSON report to write")
+    parser.add_argument('--baseline',
+                        help="earlier JSON report to compare against")
+    parser.add_argument('--tolerance', type=float, default=0.10,
+                        help="relative change against the baseline reported as a regression")
+    return parser.parse_args()
+
+def count_runs(args):
+    """Number of runs in the benchmark configuration"""
+    output = subprocess.check_output([args.binary, '-c', args.config, '-q', 'numruns'],
+                                     cwd=SIMULATIONS_DIR, text=True)
+    numbers = re.findall(r'\d+', output)
+    if not numbers:
+        raise RuntimeError(f"Cannot read the number of runs from: {output!r}")
+    return int(numbers[-1])
+
+def parse_scalars(result_dir):
+    """Iteration variables and summed CoCoChain counters of one run"""
+    itervars = {}
+    confirmed = 0
+    overhead = 0
+    for filepath in glob.glob(str(result_dir / "*.sca")):
+        with open(filepath, 'r') as f:
+            for line in f:
+                parts = line.split()
+                if len(parts) >= 3 and parts[0] == 'itervar':
+                    itervars[parts[1]] = parts[2].strip('"')
+                elif len(parts) >= 4 and parts[0] == 'scalar':
+                    metric = line.split(None, 2)[2].rsplit(None, 1)[0].strip('"')
+                    if metric == 'Confirmed transactions':
+                        confirmed += float(parts[-1])
+                    elif metric == 'consensusOverhead:sum':
+                        overhead += float(parts[-1])
+    return itervars, confirmed, overhead
+
+def run_benchmark(args, run):
+    """Run one scenario and measure it"""
+    result_dir = Path(args.result_dir) / f"run{run}"
+    if result_dir.exists():
+        shutil.rmtree(result_dir)
+    result_dir.mkdir(parents=True)
+
+    command = [args.binary, '-u', 'Cmdenv', '-c', args.config, '-r', str(run),
+               f"--result-dir={result_dir}", '--cmdenv-express-mode=true']
+    start = time.time()
+    with open(result_dir / "stdout.log", 'w+') as log:
+        process = subprocess.Popen(command, cwd=SIMULATIONS_DIR, stdout=log, stderr=subprocess.STDOUT)
+        # wait4() gives the resource usage of this child alone
+        _, status, usage = os.wait4(process.pid, 0)
+        wall_time = time.time() - start
+        log.seek(0)
+        events = EVENT_PATTERN.findall(log.read())
+
+    itervars, confirmed, overhead = parse_scalars(result_dir)
+    num_events = int(events[-1]) if events else 0
+    return {
+        'run': run,
+        'itervars': itervars,
+        'exit_code': os.waitstatus_to_exitcode(status),
+        'wall_time': wall_time,
+        'events': num_events,
+        'events_per_sec': num_events / wall_time if wall_time > 0 else 0,
+        'peak_rss_kb': usage.ru_maxrss,  # kilobytes on Linux
+        'confirmed_transactions': confirmed,
+        'consensus_overhead': overhead,
+        'overhead_per_confirmed': overhead / confirmed if confirmed else None,
+    }
+
+def compare_to_baseline(report, baseline, tolerance):
+    """List the tracked metrics that got worse by more than tolerance"""
+    previous = {json.dumps(r['itervars'], sort_keys=True): r for r in baseline['runs']}
+    regressions = []
+    for result in report['runs']:
+        old = previous.get(json.dumps(result['itervars'], sort_keys=True))
+        if old is None:
+            continue
+        for metric, higher_is_better in TRACKED_METRICS.items():
+            if not old.get(metric) or result.get(metric) is None:
+                continue
+            change = (result[metric] - old[metric]) / old[metric]
+            if (change < -tolerance) if higher_is_better else (change > tolerance):
+                regressions.append(f"{result['itervars']}: {metric} {old[metric]:.4g} -> "
+                                   f"{result[metric]:.4g} ({change:+.1%})")
+    return regressions
+
+def run_benchmarks():
+    """Run all benchmark scenarios and write the JSON report"""
+    args = parse_arguments()
+    if not os.access(args.binary, os.X_OK):
+        print(f"Simulation binary {args.binary} not found. Please run make first.")
+        return 1
+
+    runs = args.runs if args.runs is not None else range(count_runs(args))
+    report = {
+        'config': args.config,
+        'host': socket.gethostname(),
+        'cpus': os.cpu_count(),
+        'timestamp': time.strftime('%Y-%m-%dT%H:%M:%S'),
+        'runs': [],
+    }
+    try:
+        report['commit'] = subprocess.check_output(['git', 'rev-parse', 'HEAD'], cwd=REPO_DIR,
+                                                   text=True, stderr=subprocess.DEVNULL).strip()
+    except (OSError, subprocess.CalledProcessError):
+        report['commit'] = None
+
+    # Sequential on purpose: concurrent runs would disturb the timings
+    for run in runs:
+        result = run_benchmark(args, run)
+        report['runs'].append(result)
+        print(f"Run {run} {result['itervars']}: {result['wall_time']:.1f}s, "
+              f"{result['events_per_sec']:.0f} ev/s, {result['peak_rss_kb'] / 1024:.0f} MiB, "
+              f"exit {result['exit_code']}")
+
+    with open(args.output, 'w') as f:
+        json.dump(report, f, indent=2)
+    print(f"Benchmark results saved to: {args.output}")
+
+    failed = [r['run'] for r in report['runs'] if r['exit_code'] != 0]
+    if failed:
+        print(f"Runs {failed} failed; see their stdout.log under {args.result_dir}")
+
+    regressions = []
+    if args.baseline:
+        with open(args.baseline, 'r') as f:
+            regressions = compare_to_baseline(report, json.load(f), args.tolerance)
+        for regression in regressions:
+            print(f"REGRESSION {regression}")
+    return 1 if failed or regressions else 0
+
+if __name__ == "__main__":
+    sys.exit(run_benchmarks())
@@ -0,0 +1,170 @@
+#!/usr/bin/env python3
+"""
+CoCoChain Parallel Sweep Runner
+Runs repetitions x parameter combinations across all cores and merges the
+result files into one directory for analyze_results.py
+"""
+
+import os
+import sys
+import json
+import time
+import shutil
+import argparse
+import itertools
+import subprocess
+from pathlib import Path
+from concurrent.futures import ThreadPoolExecutor, as_completed
+
+SCRIPT_DIR = Path(__file__).resolve().parent
+REPO_DIR = SCRIPT_DIR.parent
+SIMULATIONS_DIR = REPO_DIR / "simulations"
+
+# Swept parameters: command-line option name -> ini key it overrides
+SWEEP_PARAMETERS = {
+    'vehicles': '**.numVehicles',
+    'corruption': '**.vehicle.app[0].corruptionProbability',
+    'threshold': '**.vehicle.app[0].bftThreshold',
+}
+
+RESULT_SUFFIXES = ('.sca', '.vec', '.vci')
+
+def parse_arguments():
+    """Parse command-line options"""
+    parser = argparse.ArgumentParser(description="Run a CoCoChain parameter sweep in parallel")
+    parser.add_argument('--vehicles', type=int, nargs='+', default=[2500],
+                        help="values of numVehicles")
+    parser.add_argument('--corruption', type=float, nargs='+', default=[0.1],
+                        help="values of corruptionProbability")
+    parser.add_argument('--threshold', type=float, nargs='+', default=[0.67],
+                        help="values of bftThreshold")
+    parser.add_argument('--repetitions', type=int, default=10,
+                        help="repetitions (seed sets) per combination")
+    parser.add_argument('--config', default='General',
+                        help="omnetpp.ini configuration to run")
+    parser.add_argument('--jobs', type=int, default=os.cpu_count() or 1,
+                        help="simulations run at the same time")
+    parser.add_argument('--binary', default=str(REPO_DIR / "CoCoChain"),
+                        help="simulation executable")
+    parser.add_argument('--work-dir', default=str(REPO_DIR / "sweep"),
+                        help="per-job result directories, logs and the sweep state")
+    parser.add_argument('--result-dir', default=str(REPO_DIR / "results"),
+                        help="merged result set read by analyze_results.py")
+    parser.add_argument('--retry-failed', action='store_true',
+                        help="run jobs that failed in an earlier invocation again")
+    parser.add_argument('--dry-run', action='store_true',
+                        help="print the pending jobs without running them")
+    return parser.parse_args()
+
+def build_jobs(args):
+    """Expand the parameter grid and repetitions into a job list"""
+    jobs = []
+    names = list(SWEEP_PARAMETERS)
+    for values in itertools.product(*(getattr(args, name) for name in names)):
+        params = dict(zip(names, values))
+        label = "-".join(f"{name}={value}" for name, value in params.items())
+        for repetition in range(args.repetitions):
+            jobs.append({
+                'id': f"{args.config}-{label}-r{repetition}",
+                'params': params,
+                'repetition': repetition,
+            })
+    return jobs
+
+def load_state(path):
+    """Load the sweep state written by an earlier invocation"""
+    if not path.exists():
+        return {}
+    with open(path, 'r') as f:
+        return json.load(f)
+
+def save_state(path, state):
+    """Write the sweep state atomically so an interrupted sweep can resume"""
+    tmp = path.with_suffix('.tmp')
+    with open(tmp, 'w') as f:
+        json.dump(state, f, indent=2, sort_keys=True)
+    os.replace(tmp, path)
+
+def run_job(job, args, work_dir):
+    """Run one simulation into its own result directory"""
+    job_dir = work_dir / job['id']
+    if job_dir.exists():
+        shutil.rmtree(job_dir)
+    job_dir.mkdir(parents=True)
+
+    command = [args.binary, '-u', 'Cmdenv', '-c', args.config,
+               '-r', str(job['repetition']),
+               f"--result-dir={job_dir}",
+               '--cmdenv-express-mode=true']
+    for name, value in job['params'].items():
+        command.append(f"--{SWEEP_PARAMETERS[name]}={value}")
+
+    start = time.time()
+    with open(job_dir / "stdout.log", 'w') as log:
+        returncode = subprocess.call(command, cwd=SIMULATIONS_DIR, stdout=log, stderr=subprocess.STDOUT)
+    return {
+        'status': 'done' if returncode == 0 else 'failed',
+        'returncode': returncode,
+        'wall_time': time.time() - start,
+        'params': job['params'],
+        'repetition': job['repetition'],
+    }
+
+def merge_results(jobs, state, work_dir, result_dir):
+    """Copy the result files of finished jobs into one flat result set"""
+    result_dir.mkdir(parents=True, exist_ok=True)
+    merged = 0
+    for job in jobs:
+        if state.get(job['id'], {}).get('status') != 'done':
+            continue
+        for path in (work_dir / job['id']).iterdir():
+            if path.suffix in RESULT_SUFFIXES:
+                # One file per job and suffix; the job ID keeps names unique
+                shutil.copyfile(path, result_dir / f"{job['id']}{path.suffix}")
+                merged += 1
+    return merged
+
+def run_sweep():
+    """Run all pending jobs of the sweep and merge their results"""
+    args = parse_arguments()
+    work_dir = Path(args.work_dir)
+    work_dir.mkdir(parents=True, exist_ok=True)
+    state_path = work_dir / "sweep_state.json"
+    state = load_state(state_path)
+
+    jobs = build_jobs(args)
+    skip = ('done',) if args.retry_failed else ('done', 'failed')
+    pending = [job for job in jobs if state.get(job['id'], {}).get('status') not in skip]
+
+    print(f"Sweep: {len(jobs)} jobs, {len(jobs) - len(pending)} already finished, "
+          f"{len(pending)} to run on {args.jobs} workers")
+    if args.dry_run:
+        for job in pending:
+            print(f"  {job['id']}")
+        return 0
+
+    if pending and not os.access(args.binary, os.X_OK):
+        print(f"Simulation binary {args.binary} not found. Please run make first.")
+        return 1
+
+    failed = 0
+    with ThreadPoolExecutor(max_workers=args.jobs) as executor:
+        futures = {executor.submit(run_job, job, args, work_dir): job for job in pending}
+        for count, future in enumerate(as_completed(futures), 1):
+            job = futures[future]
+            result = future.result()
+            state[job['id']] = result
+            save_state(state_path, state)
+            if result['status'] != 'done':
+                failed += 1
+            print(f"[{count}/{len(pending)}] {job['id']}: {result['status']} "
+                  f"({result['wall_time']:.1f}s)")
+
+    merged = merge_results(jobs, state, work_dir, Path(args.result_dir))
+    print(f"Merged {merged} result files into {args.result_dir}")
+    if failed:
+        print(f"{failed} jobs failed; see their stdout.log under {work_dir}")
+    return 1 if failed else 0
+
+if __name__ == "__main__":
+    sys.exit(run_sweep())
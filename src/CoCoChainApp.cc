@@ -7,27 +7,58 @@
 #include <inet/common/packet/Packet.h>
 #include <inet/common/TimeTag.h>
 #include <inet/networklayer/common/L3AddressResolver.h>
+#include <inet/networklayer/common/L3AddressTag_m.h>
+#include <inet/mobility/contract/IMobility.h>
 #include <cmath>
 #include <algorithm>
-#include <sstream>
-#include <iomanip>
+#include <cstring>
 
 Define_Module(CoCoChainApp);
 
 CoCoChainApp::CoCoChainApp() :
     localPort(9999),
-    sendTimer(nullptr),
-    transactionCounter(0),
+    registry(nullptr),
+    numNodes(0),
+    adversarial(false),
+    consensusEngine(nullptr),
+    spatialIndex(nullptr),
+    mobility(nullptr),
+    confirmedTransactions(nullptr),
     totalMessagesReceived(0),
+    totalTransactionsVerified(0),
     totalMalformedDetected(0),
+    totalConfirmed(0),
+    totalTimedOut(0),
+    totalRejected(0),
+    latenciesMeasured(0),
+    collector(nullptr),
     corruptionDist(0.0, 1.0),
-    conceptDist(0.0, 1.0)
+    conceptDist(0.0, 1.0),
+    sendTimer(nullptr),
+    gcTimer(nullptr),
+    verifyBatchTimer(nullptr),
+    cpuTimer(nullptr),
+    totalCpuDrops(0),
+    txTimer(nullptr),
+    channelBusyRatio(0),
+    totalTxDeadlineDrops(0),
+    totalTxOverflowDrops(0),
+    transactionCounter(0)
 {
 }
 
 CoCoChainApp::~CoCoChainApp()
 {
     cancelAndDelete(sendTimer);
+    cancelAndDelete(gcTimer);
+    cancelAndDelete(verifyBatchTimer);
+    cancelAndDelete(cpuTimer);
+    for (CpuJob& job : cpuQueue) delete job.packet;
+    cancelAndDelete(txTimer);
+    for (TxJob& job : voteTxQueue) delete job.packet;
+    for (TxJob& job : transactionTxQueue) delete job.packet;
+    delete consensusEngine;
+    delete confirmedTransactions;
 }
 
 void CoCoChainApp::initialize(int stage)
@@ -39,25 +70,174 @@ void CoCoChainApp::initialize(int stage)
         messageInterval = par("messageInterval");
         corruptionProbability = par("corruptionProbability");
         bftThreshold = par("bftThreshold").doubleValue();
-        semanticVerification = par("semanticVerification");
+        estimatedNetworkSize = par("estimatedNetworkSize");
+        minRequiredVotes = par("minRequiredVotes");
+        if (minRequiredVotes < 1)
+            throw cRuntimeError("minRequiredVotes must be positive");
+        profiler.setEnabled(par("profileHandlers"));
+        profileSocketDataArrived = profiler.add("socketDataArrived");
+        profileSendTransaction = profiler.add("sendTransaction");
+        profileComputeDigest = profiler.add("computeSemanticDigest");
+        profileVerify = profiler.add("verifySemanticIntegrity");
+        profileConsensus = profiler.add("processConsensusMessage");
+        profileExpireTransactions = profiler.add("expireTransactions");
+        latencySampleInterval = par("latencySampleInterval");
+        if (latencySampleInterval < 0)
+            throw cRuntimeError("latencySampleInterval must not be negative");
+        logSampleInterval = par("logSampleInterval");
+        if (logSampleInterval < 1)
+            throw cRuntimeError("logSampleInterval must be positive");
+        DigestAlgorithm digestAlgorithm;
+        const char *digestAlgorithmName = par("digestAlgorithm");
+        if (!strcmp(digestAlgorithmName, "fast"))
+            digestAlgorithm = DigestAlgorithm::FAST;
+        else if (!strcmp(digestAlgorithmName, "sha256"))
+            digestAlgorithm = DigestAlgorithm::SHA256;
+        else
+            throw cRuntimeError("Unknown digestAlgorithm '%s'", digestAlgorithmName);
+        verifier = SemanticVerifier(par("semanticVerification").boolValue(), par("varianceThreshold").doubleValue(),
+                par("maxAbsThreshold").doubleValue(), digestAlgorithm);
+        int verifyCacheSize = par("verifyCacheSize");
+        if (verifyCacheSize < 0)
+            throw cRuntimeError("verifyCacheSize must not be negative");
+        verifyCache.resize(verifyCacheSize);
+        cpuModel = par("cpuModel");
+        cpuPacketCost = par("cpuPacketCost");
+        cpuDigestCost = par("cpuDigestCost");
+        cpuSignatureCost = par("cpuSignatureCost");
+        cpuVoteCost = par("cpuVoteCost");
+        cpuQueueLength = par("cpuQueueLength");
+        txScheduler = par("txScheduler");
+        txRate = par("txRate");
+        txMinRate = par("txMinRate");
+        if (txMinRate <= 0 || txMinRate > txRate)
+            throw cRuntimeError("txMinRate must be positive and not above txRate");
+        targetBusyRatio = par("targetBusyRatio");
+        channelBitrate = par("channelBitrate");
+        busyRatioWindow = par("busyRatioWindow");
+        txQueueLength = par("txQueueLength");
+        txBucket.configure(txRate, par("txBurst").intValue(), 0);
+        verifyBatchWindow = par("verifyBatchWindow");
+        verifyBatchSize = par("verifyBatchSize");
+        if (verifyBatchSize < 1)
+            throw cRuntimeError("verifyBatchSize must be positive");
         maxTransactionAge = par("maxTransactionAge");
+        gcInterval = par("gcInterval");
+        transmitConceptVector = par("transmitConceptVector");
+        conceptDimensions = par("conceptDimensions");
+        if (conceptDimensions < 1)
+            throw cRuntimeError("conceptDimensions must be positive");
+        const char *conceptEncodingName = par("conceptEncoding");
+        if (!strcmp(conceptEncodingName, "float64"))
+            conceptEncoding = ConceptEncoding::FLOAT64;
+        else if (!strcmp(conceptEncodingName, "float32"))
+            conceptEncoding = ConceptEncoding::FLOAT32;
+        else if (!strcmp(conceptEncodingName, "int8"))
+            conceptEncoding = ConceptEncoding::INT8;
+        else
+            throw cRuntimeError("Unknown conceptEncoding '%s'", conceptEncodingName);
+        cModule *node = getContainingNode(this);
+        // Shared modules are reached by direct method calls, which cannot
+        // cross partitions of a parallel simulation
+        bool parallel = getEnvir()->getParsimNumPartitions() > 1;
+        if (par("registryModule").stdstringValue().empty()) {
+            if (!node->isVector())
+                throw cRuntimeError("Without a registryModule the node must be an element of a module vector");
+            numNodes = node->getVectorSize();
+        }
+        else if (parallel)
+            throw cRuntimeError("registryModule must be empty in a parallel simulation");
+        else
+            registry = getModuleFromPar<CoCoChainRegistry>(par("registryModule"), this);
+        
+        if (!par("collectorModule").stdstringValue().empty()) {
+            if (parallel)
+                throw cRuntimeError("collectorModule must be empty in a parallel simulation");
+            collector = getModuleFromPar<CoCoChainCollector>(par("collectorModule"), this);
+            collector->registerNode();
+        }
+        recordNodeScalars = par("recordNodeScalars");
+        
+        // Where the neighbourhood size for quorums comes from
+        const char *neighbourSource = par("neighbourSource");
+        if (!strcmp(neighbourSource, "spatial")) {
+            if (parallel)
+                throw cRuntimeError("neighbourSource \"spatial\" is not supported in a parallel simulation");
+            spatialIndex = getModuleFromPar<SpatialIndex>(par("spatialIndexModule"), this);
+            mobility = check_and_cast<IMobility *>(node->getSubmodule("mobility"));
+            communicationRange = par("communicationRange");
+        }
+        else if (strcmp(neighbourSource, "overheard"))
+            throw cRuntimeError("Unknown neighbourSource '%s'", neighbourSource);
+        
+        // Voting protocol
+        const char *consensusMode = par("consensusMode");
+        int voteBatchSize = par("voteBatchSize");
+        if (voteBatchSize < 1 || voteBatchSize > COCOCHAIN_MAX_VOTE_BATCH)
+            throw cRuntimeError("voteBatchSize must be between 1 and %d", COCOCHAIN_MAX_VOTE_BATCH);
+        if (!strcmp(consensusMode, "broadcast"))
+            consensusEngine = new BroadcastConsensusEngine(*this, this, par("voteBatchWindow"), voteBatchSize);
+        else if (!strcmp(consensusMode, "gossip"))
+            consensusEngine = new GossipConsensusEngine(*this, this, par("voteBatchWindow"), voteBatchSize,
+                    par("gossipCoverage").doubleValue(), par("gossipFanout").intValue());
+        else if (!strcmp(consensusMode, "aggregated"))
+            consensusEngine = new AggregatedConsensusEngine(*this, this, par("aggregateVerifyDelay"), par("aggregateKeyDelay"));
+        else
+            throw cRuntimeError("Unknown consensusMode '%s'", consensusMode);
+        
+        // Presize transaction tables for the number of transactions expected
+        // to be live at once (arrival rate x maximum age)
+        double expectedTransactionRate = par("expectedTransactionRate");
+        if (expectedTransactionRate > 0) {
+            size_t expectedLive = static_cast<size_t>(std::ceil(expectedTransactionRate * maxTransactionAge.dbl()));
+            pendingTransactions.reserve(expectedLive);
+            consensusEngine->reserve(expectedLive);
+            transactionStartTimes.reserve(static_cast<size_t>(std::ceil(maxTransactionAge / messageInterval)));
+        }
         
         // Initialize random number generator
         int seed = getRNG(0)->intRand();
         rng.seed(seed);
         
+        // Duplicate guard for finalizeTransaction()
+        const char *dedupFilter = par("dedupFilter");
+        if (!strcmp(dedupFilter, "exact"))
+            confirmedTransactions = new ExactDedupFilter();
+        else if (!strcmp(dedupFilter, "window"))
+            confirmedTransactions = new SlidingWindowDedupFilter(par("dedupWindowSize").intValue());
+        else if (!strcmp(dedupFilter, "bloom"))
+            confirmedTransactions = new RotatingBloomFilter(par("bloomCapacity").intValue(), par("bloomFalsePositiveRate").doubleValue());
+        else
+            throw cRuntimeError("Unknown dedupFilter '%s'", dedupFilter);
+        
         // Register signals for statistics
         endToEndLatencySignal = registerSignal("endToEndLatency");
+        endToEndLatencySampleSignal = registerSignal("endToEndLatencySample");
         consensusOverheadSignal = registerSignal("consensusOverhead");
         malformedDetectedSignal = registerSignal("malformedDetected");
+        timedOutSignal = registerSignal("timedOut");
+        neighbourCountSignal = registerSignal("neighbourCount");
+        hopDelaySignal = registerSignal("hopDelay");
+        pendingDepthSignal = registerSignal("pendingDepth");
+        cpuQueueingDelaySignal = registerSignal("cpuQueueingDelay");
+        cpuDropSignal = registerSignal("cpuDrop");
+        txQueueingDelaySignal = registerSignal("txQueueingDelay");
+        txDropSignal = registerSignal("txDrop");
+        channelBusyRatioSignal = registerSignal("channelBusyRatio");
         
-        // Determine if this node is adversarial (10% of nodes)
-        if (corruptionDist(rng) < corruptionProbability) {
-            adversarialNodes.insert(getId());
-            EV_INFO << "Node " << getId() << " configured as adversarial" << endl;
+        // Determine if this node is adversarial (10% of nodes) and get our dense index
+        // Without a registry the vehicle index is the dense index
+        adversarial = corruptionDist(rng) < corruptionProbability;
+        nodeIndex = registry ? registry->registerNode(getId(), adversarial) : node->getIndex();
+        if (adversarial) {
+            EV_SUMMARY << "Node " << nodeIndex << " configured as adversarial" << endl;
         }
         
         sendTimer = new cMessage("sendTimer");
+        gcTimer = new cMessage("gcTimer");
+        verifyBatchTimer = new cMessage("verifyBatchTimer");
+        cpuTimer = new cMessage("cpuTimer");
+        txTimer = new cMessage("txTimer");
     }
     else if (stage == INITSTAGE_APPLICATION_LAYER) {
         // Setup UDP socket
@@ -68,6 +248,11 @@ void CoCoChainApp::initialize(int stage)
         
         // Schedule first message
         scheduleAt(simTime() + uniform(0, messageInterval.dbl()), sendTimer);
+        
+        // Periodically evict state of transactions older than maxTransactionAge
+        if (gcInterval > 0) {
+            scheduleAt(simTime() + gcInterval, gcTimer);
+        }
     }
 }
 
@@ -77,209 +262,541 @@ void CoCoChainApp::handleMessageWhenUp(cMessage *msg)
         sendTransaction();
         scheduleNextMessage();
     }
-    else {
+    else if (msg == gcTimer) {
+        expireTransactions();
+        scheduleAt(simTime() + gcInterval, gcTimer);
+    }
+    else if (msg == verifyBatchTimer) {
+        flushVerifyBatch();
+    }
+    else if (msg == cpuTimer) {
+        CpuJob job = cpuQueue.front();
+        cpuQueue.pop_front();
+        processPacket(job.packet, job.tx);
+        if (!cpuQueue.empty()) startCpuJob();
+    }
+    else if (msg == txTimer) {
+        sendQueuedPackets();
+    }
+    else if (!consensusEngine->handleTimer(msg)) {
         ApplicationBase::handleMessageWhenUp(msg);
     }
 }
 
-void CoCoChainApp::socketDataArrived(UdpSocket *socket, Packet *packet)
+void CoCoChainApp::socketDataArrived(UdpSocket *, Packet *packet)
 {
+    ScopedHandlerTimer timer(profiler.get(profileSocketDataArrived));
     totalMessagesReceived++;
     emit(consensusOverheadSignal, 1); // Count each message as overhead
-    
-    // Extract message data (simplified - in real implementation would use proper serialization)
-    auto chunk = packet->peekDataAt<BytesChunk>(B(0), packet->getDataLength());
-    std::string data = chunk->getBytes().str();
-    
-    // Parse message type and content
-    if (data.find("TRANSACTION:") == 0) {
-        // Parse transaction
-        Transaction tx;
-        // Simplified parsing - in real implementation would use proper serialization
-        std::istringstream iss(data.substr(12));
-        iss >> tx.id >> tx.originator >> tx.timestamp;
-        
-        // Generate concept vector for this transaction
-        tx.conceptVector = generateConceptVector();
-        tx.semanticDigest = computeSemanticDigest(tx.conceptVector);
-        
-        processReceivedTransaction(tx);
-    }
-    else if (data.find("CONSENSUS:") == 0) {
-        // Parse consensus message
-        ConsensusMessage msg;
-        std::istringstream iss(data.substr(10));
-        int type;
-        iss >> type >> msg.transactionId >> msg.senderId >> msg.vote >> msg.timestamp;
-        msg.type = static_cast<ConsensusMessage::Type>(type);
-        
-        processConsensusMessage(msg);
+    if (txScheduler) noteAirtime(packet);
+    // Before any CPU queueing, so hopDelay stays a network delay
+    noteSender(packet);
+    
+    if (cpuModel)
+        enqueueCpuJob(packet);
+    else
+        processPacket(packet, nullptr);
+}
+
+void CoCoChainApp::noteSender(Packet *packet)
+{
+    const auto& header = packet->peekAtFront<CoCoChainHeader>();
+    int sender;
+    uint64_t sentAt;
+    
+    switch (header->getMessageType()) {
+        case COCOCHAIN_TRANSACTION: {
+            const auto& txPacket = packet->peekAtFront<CoCoChainTransactionPacket>();
+            sender = txPacket->getOriginator();
+            sentAt = txPacket->getTimestamp();
+            break;
+        }
+        case COCOCHAIN_CONSENSUS: {
+            const auto& consensusPacket = packet->peekAtFront<CoCoChainConsensusPacket>();
+            sender = consensusPacket->getSenderIndex();
+            sentAt = consensusPacket->getTimestamp();
+            break;
+        }
+        case COCOCHAIN_VOTE_BATCH: {
+            const auto& batchPacket = packet->peekAtFront<CoCoChainVoteBatchPacket>();
+            sender = batchPacket->getSenderIndex();
+            sentAt = batchPacket->getTimestamp();
+            break;
+        }
+        case COCOCHAIN_COMMIT: {
+            const auto& commitPacket = packet->peekAtFront<CoCoChainCommitPacket>();
+            sender = commitPacket->getSenderIndex();
+            sentAt = commitPacket->getTimestamp();
+            break;
+        }
+        default:
+            return;
+    }
+    if (sender != nodeIndex) noteHeard(sender, sentAt);
+}
+
+void CoCoChainApp::processPacket(Packet *packet, Transaction *tx)
+{
+    const auto& header = packet->peekAtFront<CoCoChainHeader>();
+    
+    switch (header->getMessageType()) {
+        case COCOCHAIN_TRANSACTION:
+            processReceivedTransaction(tx ? tx : decodeTransaction(packet));
+            break;
+        default: {
+            // Votes, batches and COMMITs belong to the consensus engine
+            ScopedHandlerTimer consensusTimer(profiler.get(profileConsensus));
+            if (!consensusEngine->handlePacket(packet, header->getMessageType()))
+                EV_WARN << "Ignoring packet with unknown message type " << header->getMessageType() << endl;
+            break;
+        }
     }
     
     delete packet;
 }
 
-void CoCoChainApp::socketErrorArrived(UdpSocket *socket, Indication *indication)
+Transaction *CoCoChainApp::decodeTransaction(Packet *packet)
+{
+    const auto& txPacket = packet->peekAtFront<CoCoChainTransactionPacket>();
+    
+    // Decode straight into a pooled transaction; it is moved into
+    // pendingTransactions or recycled, never copied
+    Transaction *tx = transactionPool.acquire();
+    tx->id = txPacket->getTransactionId();
+    tx->originator = txPacket->getOriginator();
+    tx->originatorAddress = packet->getTag<L3AddressInd>()->getSrcAddress();
+    tx->timestamp = txPacket->getTimestamp();
+    tx->verified = false;
+    tx->hasVerifyCacheKey = false;
+    
+    if (transmitConceptVector) {
+        // Verify exactly what the sender put on the wire
+        size_t dimensions = txPacket->getConceptDataArraySize();
+        tx->conceptVector.data.resize(dimensions);
+        for (size_t i = 0; i < dimensions; i++) {
+            tx->conceptVector.data[i] = txPacket->getConceptData(i);
+        }
+        tx->conceptVector.nodeId = tx->originator;
+        tx->conceptVector.timestamp = tx->timestamp;
+        tx->conceptVector.isCorrupted = false;
+        tx->semanticDigest = txPacket->getSemanticDigest();
+    }
+    else {
+        // Legacy mode: generate concept vector for this transaction locally
+        generateConceptVector(tx->conceptVector);
+        tx->semanticDigest = computeSemanticDigest(tx->conceptVector);
+    }
+    return tx;
+}
+
+void CoCoChainApp::enqueueCpuJob(Packet *packet)
+{
+    if (cpuQueueLength > 0 && static_cast<int>(cpuQueue.size()) >= cpuQueueLength) {
+        totalCpuDrops++;
+        emit(cpuDropSignal, 1);
+        EV_PACKET << "CPU queue full, dropping " << packet->getName() << endl;
+        delete packet;
+        return;
+    }
+    cpuQueue.push_back({packet, nullptr, simTime()});
+    if (!cpuTimer->isScheduled()) startCpuJob();
+}
+
+void CoCoChainApp::startCpuJob()
+{
+    CpuJob& job = cpuQueue.front();
+    emit(cpuQueueingDelaySignal, (simTime() - job.enqueuedAt).dbl());
+    
+    // Service time from the operations the packet will cost
+    simtime_t cost = cpuPacketCost;
+    const auto& header = job.packet->peekAtFront<CoCoChainHeader>();
+    switch (header->getMessageType()) {
+        case COCOCHAIN_TRANSACTION: {
+            // Decoded now so that a cached verdict makes verification free
+            job.tx = decodeTransaction(job.packet);
+            // Own and stale transactions are discarded without verification
+            if (job.tx->originator == nodeIndex || simTime() - SimTime(job.tx->timestamp, SIMTIME_US) > maxTransactionAge)
+                break;
+            bool cached = verifyCache.isEnabled() && verifyCache.contains(getVerifyCacheKey(*job.tx));
+            if (verifier.isEnabled() && !cached) cost += cpuDigestCost + cpuSignatureCost;
+            break;
+        }
+        case COCOCHAIN_VOTE_BATCH:
+            cost += cpuVoteCost * (double)job.packet->peekAtFront<CoCoChainVoteBatchPacket>()->getTransactionIdsArraySize();
+            break;
+        default:
+            cost += cpuVoteCost;
+            break;
+    }
+    cpuBusyTime += cost;
+    scheduleAt(simTime() + cost, cpuTimer);
+}
+
+void CoCoChainApp::socketErrorArrived(UdpSocket *, Indication *indication)
 {
     EV_WARN << "Socket error: " << indication->str() << endl;
     delete indication;
 }
 
-void CoCoChainApp::socketClosed(UdpSocket *socket)
+void CoCoChainApp::socketClosed(UdpSocket *)
 {
     // Socket closed
 }
 
 void CoCoChainApp::sendTransaction()
 {
+    ScopedHandlerTimer timer(profiler.get(profileSendTransaction));
     Transaction tx;
-    tx.id = ++transactionCounter + (getId() * 1000000ULL); // Ensure unique IDs
-    tx.originator = getId();
+    tx.id = makeTransactionId(nodeIndex, ++transactionCounter); // Ensure unique IDs
+    tx.originator = nodeIndex;
     tx.timestamp = simTime().inUnit(SIMTIME_US);
-    tx.conceptVector = generateConceptVector();
+    generateConceptVector(tx.conceptVector);
     
     // Apply corruption if this is an adversarial node
     if (isAdversarialNode()) {
         injectMalformedVector(tx.conceptVector);
     }
     
+    // Round to the on-air representation so receivers decode the exact values we hash
+    if (transmitConceptVector) {
+        quantizeConcept(tx.conceptVector.data.data(), tx.conceptVector.data.size(), conceptEncoding);
+    }
+    
     tx.semanticDigest = computeSemanticDigest(tx.conceptVector);
     
     // Record start time for latency measurement
     transactionStartTimes[tx.id] = simTime();
+    consensusEngine->trackTransaction(tx.id, getRequiredVotes());
     
     // Broadcast transaction
-    std::ostringstream oss;
-    oss << "TRANSACTION:" << tx.id << " " << tx.originator << " " << tx.timestamp;
-    std::string data = oss.str();
+    auto txPacket = makeShared<CoCoChainTransactionPacket>();
+    txPacket->setTransactionId(tx.id);
+    txPacket->setOriginator(tx.originator);
+    txPacket->setTimestamp(tx.timestamp);
+    txPacket->setSemanticDigest(tx.semanticDigest);
+    if (transmitConceptVector) {
+        const auto& data = tx.conceptVector.data;
+        txPacket->setConceptEncoding(static_cast<uint8_t>(conceptEncoding));
+        txPacket->setConceptDataArraySize(data.size());
+        for (size_t i = 0; i < data.size(); i++) {
+            txPacket->setConceptData(i, data[i]);
+        }
+        txPacket->setChunkLength(COCOCHAIN_TRANSACTION_HEADER_LENGTH + B(getEncodedConceptLength(conceptEncoding, data.size())));
+    }
     
-    auto packet = new Packet("CoCoChainTransaction");
-    packet->insertAtBack(makeShared<BytesChunk>(reinterpret_cast<const uint8_t*>(data.c_str()), data.length()));
+    auto packet = new Packet("CoCoChainTransaction", txPacket);
     
-    socket.sendTo(packet, Ipv4Address::ALLONES_ADDRESS, localPort);
+    // Receivers drop transactions older than maxTransactionAge
+    transmit(packet, Ipv4Address::ALLONES_ADDRESS, false, SimTime(tx.timestamp, SIMTIME_US) + maxTransactionAge);
     
-    EV_INFO << "Sent transaction " << tx.id << " with " << 
+    EV_TX(tx.id, logSampleInterval) << "Sent transaction " << tx.id << " with " << 
                (tx.conceptVector.isCorrupted ? "corrupted" : "clean") << " concept vector" << endl;
 }
 
-void CoCoChainApp::processReceivedTransaction(const Transaction& tx)
+void CoCoChainApp::processReceivedTransaction(Transaction *tx)
 {
     // Skip our own transactions
-    if (tx.originator == getId()) return;
+    if (tx->originator == nodeIndex) {
+        transactionPool.release(tx);
+        return;
+    }
     
     // Check if transaction is too old
-    simtime_t age = simTime() - SimTime(tx.timestamp, SIMTIME_US);
+    simtime_t age = simTime() - SimTime(tx->timestamp, SIMTIME_US);
     if (age > maxTransactionAge) {
-        EV_INFO << "Dropping old transaction " << tx.id << endl;
+        EV_TX(tx->id, logSampleInterval) << "Dropping old transaction " << tx->id << endl;
+        transactionPool.release(tx);
         return;
     }
     
-    // Verify semantic integrity
-    bool isValid = verifySemanticIntegrity(tx);
+    // Queue for the next batch verification, or verify right away
+    if (verifyBatchWindow > 0) {
+        // Payloads verified before skip the queue
+        bool cacheable = verifier.isEnabled() && verifyCache.isEnabled();
+        if (cacheable) {
+            int cached = verifyCache.lookup(getVerifyCacheKey(*tx));
+            if (cached >= 0) {
+                processVerifiedTransaction(tx, cached);
+                return;
+            }
+        }
+        verifyQueue.push_back(tx);
+        // The batch references the pooled transaction's vector; with the
+        // fast digest the fingerprint already is the digest
+        if (cacheable && verifier.getDigestAlgorithm() == DigestAlgorithm::FAST)
+            verifyBatch.add(tx->conceptVector.data, tx->semanticDigest, tx->payloadFingerprint);
+        else
+            verifyBatch.add(tx->conceptVector.data, tx->semanticDigest);
+        if (static_cast<int>(verifyQueue.size()) >= verifyBatchSize) {
+            cancelEvent(verifyBatchTimer);
+            flushVerifyBatch();
+        }
+        else if (!verifyBatchTimer->isScheduled()) {
+            scheduleAt(simTime() + verifyBatchWindow, verifyBatchTimer);
+        }
+        return;
+    }
+    processVerifiedTransaction(tx, verifySemanticIntegrity(*tx));
+}
+
+void CoCoChainApp::flushVerifyBatch()
+{
+    {
+        ScopedHandlerTimer timer(profiler.get(profileVerify));
+        verifier.verifyBatch(verifyBatch, verifyVerdicts);
+    }
+    EV_PACKET << "Verified a batch of " << verifyQueue.size() << " transactions" << endl;
+    
+    if (verifier.isEnabled() && verifyCache.isEnabled()) {
+        for (size_t i = 0; i < verifyQueue.size(); i++)
+            verifyCache.insert(verifyQueue[i]->verifyCacheKey, verifyVerdicts[i]);
+    }
+    
+    // Votes cast here join the engine's pending vote batch when voteBatchWindow > 0
+    for (size_t i = 0; i < verifyQueue.size(); i++)
+        processVerifiedTransaction(verifyQueue[i], verifyVerdicts[i]);
+    verifyQueue.clear();
+    verifyBatch.clear();
+}
+
+void CoCoChainApp::processVerifiedTransaction(Transaction *tx, bool isValid)
+{
+    totalTransactionsVerified++;
+    if (collector && registry) {
+        // Detection against ground truth, for the network summary
+        if (registry->isAdversarial(tx->originator)) {
+            collectorSummary.adversarialVerified++;
+            if (!isValid) collectorSummary.adversarialDetected++;
+        }
+        else {
+            collectorSummary.honestVerified++;
+            if (!isValid) collectorSummary.honestDetected++;
+        }
+    }
     if (!isValid) {
         totalMalformedDetected++;
         emit(malformedDetectedSignal, 1);
-        EV_INFO << "Detected and rejected malformed transaction " << tx.id << endl;
+        EV_TX(tx->id, logSampleInterval) << "Detected and rejected malformed transaction " << tx->id << endl;
+        transactionPool.release(tx);
         return;
     }
     
     // Store transaction and start consensus
-    pendingTransactions[tx.id] = tx;
-    startConsensus(tx);
+    auto entry = pendingTransactions.tryEmplace(tx->id);
+    if (!entry.second) {
+        // Duplicate reception, keep the stored copy
+        transactionPool.release(tx);
+        return;
+    }
+    *entry.first = tx;
+    tx->verified = true;
+    
+    // Vote, with the quorum snapshotted from the current neighbourhood
+    consensusEngine->startConsensus(*tx, getRequiredVotes());
 }
 
-void CoCoChainApp::startConsensus(const Transaction& tx)
+void CoCoChainApp::sendConsensusPacket(Packet *packet, const L3Address& destAddr, uint64_t transactionTimestamp)
 {
-    // Create and send vote message
-    ConsensusMessage vote;
-    vote.type = ConsensusMessage::VOTE;
-    vote.transactionId = tx.id;
-    vote.senderId = getId();
-    vote.vote = verifySemanticIntegrity(tx); // Vote based on verification
-    vote.timestamp = simTime().inUnit(SIMTIME_US);
-    
-    // Broadcast vote
-    std::ostringstream oss;
-    oss << "CONSENSUS:" << static_cast<int>(vote.type) << " " << vote.transactionId << " " 
-        << vote.senderId << " " << vote.vote << " " << vote.timestamp;
-    std::string data = oss.str();
-    
-    auto packet = new Packet("CoCoChainConsensus");
-    packet->insertAtBack(makeShared<BytesChunk>(reinterpret_cast<const uint8_t*>(data.c_str()), data.length()));
-    
-    socket.sendTo(packet, Ipv4Address::ALLONES_ADDRESS, localPort);
-    
-    EV_INFO << "Sent " << (vote.vote ? "positive" : "negative") << " vote for transaction " << tx.id << endl;
+    transmit(packet, destAddr, true, SimTime(transactionTimestamp, SIMTIME_US) + maxTransactionAge);
 }
 
-void CoCoChainApp::processConsensusMessage(const ConsensusMessage& msg)
+void CoCoChainApp::transmit(Packet *packet, const L3Address& destAddr, bool isVote, simtime_t deadline)
 {
-    if (msg.type != ConsensusMessage::VOTE) return;
-    
-    // Store vote
-    consensusVotes[msg.transactionId].push_back(msg);
-    
-    // Check if we have enough votes to reach consensus
-    auto& votes = consensusVotes[msg.transactionId];
-    int totalVotes = votes.size();
-    int positiveVotes = 0;
+    if (!txScheduler) {
+        socket.sendTo(packet, destAddr, localPort);
+        return;
+    }
     
-    for (const auto& vote : votes) {
-        if (vote.vote) positiveVotes++;
+    // A full queue gives up the packet with the earliest deadline, which may
+    // be the new one
+    std::deque<TxJob>& queue = isVote ? voteTxQueue : transactionTxQueue;
+    if (txQueueLength > 0 && static_cast<int>(queue.size()) >= txQueueLength) {
+        totalTxOverflowDrops++;
+        emit(txDropSignal, 1);
+        if (deadline <= queue.front().deadline) {
+            EV_PACKET << "Transmit queue full, dropping " << packet->getName() << endl;
+            delete packet;
+            return;
+        }
+        EV_PACKET << "Transmit queue full, dropping " << queue.front().packet->getName() << endl;
+        delete queue.front().packet;
+        queue.pop_front();
+    }
+    // Deadlines mostly arrive in order, so the scan from the back is short
+    auto pos = queue.end();
+    while (pos != queue.begin() && (pos - 1)->deadline > deadline) --pos;
+    queue.insert(pos, TxJob{packet, destAddr, simTime(), deadline});
+    if (!txTimer->isScheduled()) sendQueuedPackets();
+}
+
+void CoCoChainApp::sendQueuedPackets()
+{
+    simtime_t now = simTime();
+    
+    // Refresh the busy ratio estimate once per window and adapt the rate:
+    // above targetBusyRatio the rate shrinks in proportion
+    if (now - busyWindowStart >= busyRatioWindow) {
+        channelBusyRatio = now > busyWindowStart ? busyWindowAirtime.dbl() / (now - busyWindowStart).dbl() : 0.0;
+        emit(channelBusyRatioSignal, channelBusyRatio);
+        double rate = txRate;
+        if (channelBusyRatio > targetBusyRatio)
+            rate = std::max(txMinRate, txRate * targetBusyRatio / channelBusyRatio);
+        txBucket.setRate(rate, now.dbl());
+        busyWindowStart = now;
+        busyWindowAirtime = 0;
     }
     
-    // Need to estimate total network size for BFT threshold
-    // For simplicity, use a conservative estimate
-    int estimatedNetworkSize = 100; // Conservative estimate of local neighborhood
-    int requiredVotes = static_cast<int>(estimatedNetworkSize * bftThreshold);
+    // Everything past its deadline goes before anything is sent
+    dropExpiredTxJobs(voteTxQueue, now);
+    dropExpiredTxJobs(transactionTxQueue, now);
     
-    if (totalVotes >= requiredVotes) {
-        bool consensus = (positiveVotes >= requiredVotes);
-        
-        if (consensus) {
-            finalizeTransaction(msg.transactionId);
-        } else {
-            // Transaction rejected by consensus
-            pendingTransactions.erase(msg.transactionId);
-            consensusVotes.erase(msg.transactionId);
-            EV_INFO << "Transaction " << msg.transactionId << " rejected by consensus" << endl;
+    while (!voteTxQueue.empty() || !transactionTxQueue.empty()) {
+        std::deque<TxJob>& queue = !voteTxQueue.empty() ? voteTxQueue : transactionTxQueue;
+        if (!txBucket.tryTake(now.dbl())) {
+            // At least 1us ahead, so rounding cannot spin on the same instant
+            scheduleAt(std::max(now + SimTime(1, SIMTIME_US), SimTime(txBucket.nextTokenAt(now.dbl()))), txTimer);
+            return;
         }
+        TxJob job = queue.front();
+        queue.pop_front();
+        emit(txQueueingDelaySignal, (now - job.enqueuedAt).dbl());
+        noteAirtime(job.packet);
+        socket.sendTo(job.packet, job.destAddr, localPort);
     }
 }
 
+void CoCoChainApp::dropExpiredTxJobs(std::deque<TxJob>& queue, simtime_t now)
+{
+    // In deadline order, the expired packets are a prefix of the queue
+    while (!queue.empty() && queue.front().deadline < now) {
+        totalTxDeadlineDrops++;
+        emit(txDropSignal, 1);
+        EV_PACKET << "Deadline passed, dropping " << queue.front().packet->getName() << endl;
+        delete queue.front().packet;
+        queue.pop_front();
+    }
+}
+
+void CoCoChainApp::noteAirtime(const Packet *packet)
+{
+    busyWindowAirtime += packet->getByteLength() * 8 / channelBitrate;
+}
+
 void CoCoChainApp::finalizeTransaction(uint64_t txId)
 {
-    if (confirmedTransactions.count(txId)) return; // Already confirmed
-    
-    confirmedTransactions.insert(txId);
+    if (!confirmedTransactions->insert(txId, simTime().inUnit(SIMTIME_US))) return; // Already confirmed
+    totalConfirmed++;
     
     // Record end-to-end latency if we initiated this transaction
-    if (transactionStartTimes.count(txId)) {
-        simtime_t latency = simTime() - transactionStartTimes[txId];
+    if (simtime_t *startTime = transactionStartTimes.find(txId)) {
+        simtime_t latency = simTime() - *startTime;
         emit(endToEndLatencySignal, latency.dbl());
+        if (latencySampleInterval > 0 && ++latenciesMeasured % latencySampleInterval == 0)
+            emit(endToEndLatencySampleSignal, latency.dbl());
+        if (collector)
+            latencyHistogram.add(latency.dbl());
         transactionStartTimes.erase(txId);
-        EV_INFO << "Transaction " << txId << " confirmed with latency " << latency << "s" << endl;
+        EV_TX(txId, logSampleInterval) << "Transaction " << txId << " confirmed with latency " << latency << "s" << endl;
     }
     
     // Clean up
-    pendingTransactions.erase(txId);
-    consensusVotes.erase(txId);
+    dropPendingTransaction(txId);
+}
+
+void CoCoChainApp::rejectTransaction(uint64_t txId)
+{
+    totalRejected++;
+    // A rejected transaction of ours is an outcome, not a timeout
+    transactionStartTimes.erase(txId);
+    dropPendingTransaction(txId);
+}
+
+void CoCoChainApp::noteHeard(int nodeIndex, uint64_t sentAt)
+{
+    neighbourLastHeard[nodeIndex] = simTime();
+    
+    // One-hop delay: MAC queueing, channel access and airtime
+    emit(hopDelaySignal, (simTime() - SimTime(sentAt, SIMTIME_US)).dbl());
+}
+
+int CoCoChainApp::getNeighbourhoodSize() const
+{
+    if (estimatedNetworkSize > 0) return estimatedNetworkSize;
+    
+    // Nodes in radio range right now, excluding ourselves
+    if (spatialIndex) return std::max(0, spatialIndex->countInRange(mobility->getCurrentPosition(), communicationRange) - 1);
+    
+    // Neighbours heard within maxTransactionAge are the ones able to vote;
+    // entries are pruned by the GC sweep, so staleness is bounded by gcInterval
+    return static_cast<int>(neighbourLastHeard.size());
+}
+
+int CoCoChainApp::getRequiredVotes() const
+{
+    // The floor keeps a node with a still empty or just emptied neighbour
+    // table from finalizing on a single, possibly adversarial, vote
+    return std::max(minRequiredVotes, static_cast<int>(std::ceil(getNeighbourhoodSize() * bftThreshold)));
+}
+
+void CoCoChainApp::dropPendingTransaction(uint64_t txId)
+{
+    if (Transaction **tx = pendingTransactions.find(txId)) {
+        transactionPool.release(*tx);
+        pendingTransactions.erase(txId);
+    }
 }
 
-ConceptVector CoCoChainApp::generateConceptVector()
+void CoCoChainApp::expireTransactions()
 {
-    ConceptVector cv;
-    cv.nodeId = getId();
+    ScopedHandlerTimer timer(profiler.get(profileExpireTransactions));
+    simtime_t now = simTime();
+    uint64_t cutoffUs = now > maxTransactionAge ? (now - maxTransactionAge).inUnit(SIMTIME_US) : 0;
+    int timedOut = 0;
+    
+    // Received transactions that never reached quorum
+    timedOut += pendingTransactions.eraseIf([&](uint64_t, Transaction *tx) {
+        if (tx->timestamp >= cutoffUs) return false;
+        transactionPool.release(tx);
+        return true;
+    });
+    
+    // Our own transactions that were never confirmed
+    timedOut += transactionStartTimes.eraseIf([&](uint64_t, const simtime_t& startTime) {
+        return now - startTime > maxTransactionAge;
+    });
+    
+    // Vote tallies of transactions that are no longer pending
+    consensusEngine->expire(cutoffUs);
+    
+    // Neighbours that have been silent for maxTransactionAge
+    neighbourLastHeard.eraseIf([&](uint64_t, const simtime_t& lastHeard) {
+        return now - lastHeard > maxTransactionAge;
+    });
+    emit(neighbourCountSignal, (long)neighbourLastHeard.size());
+    emit(pendingDepthSignal, (long)pendingTransactions.size());
+    
+    // Late votes and duplicates cannot arrive for transactions older than
+    // maxTransactionAge, so confirmed IDs can be forgotten after that
+    confirmedTransactions->expire(cutoffUs);
+    
+    if (timedOut > 0) {
+        totalTimedOut += timedOut;
+        emit(timedOutSignal, timedOut);
+        EV_SUMMARY << "Expired " << timedOut << " transactions without consensus" << endl;
+    }
+}
+
+void CoCoChainApp::generateConceptVector(ConceptVector& cv)
+{
+    cv.nodeId = nodeIndex;
     cv.timestamp = simTime().inUnit(SIMTIME_US);
     cv.isCorrupted = false;
     
     // Generate random concept vector (simplified)
-    cv.data.resize(10); // 10-dimensional concept space
-    for (int i = 0; i < 10; i++) {
+    cv.data.resize(conceptDimensions);
+    for (int i = 0; i < conceptDimensions; i++) {
         cv.data[i] = conceptDist(rng);
     }
-    
-    return cv;
 }
 
 void CoCoChainApp::corruptConceptVector(ConceptVector& cv)
@@ -291,59 +808,49 @@ void CoCoChainApp::corruptConceptVector(ConceptVector& cv)
     }
 }
 
-std::string CoCoChainApp::computeSemanticDigest(const ConceptVector& cv)
+SemanticDigest CoCoChainApp::computeSemanticDigest(const ConceptVector& cv)
 {
-    // Simplified semantic digest using hash of concept vector
-    std::ostringstream oss;
-    oss << std::fixed << std::setprecision(6);
-    for (const auto& val : cv.data) {
-        oss << val << ";";
-    }
-    
-    std::string data = oss.str();
-    std::hash<std::string> hasher;
-    size_t hash = hasher(data);
-    
-    std::ostringstream result;
-    result << std::hex << hash;
-    return result.str();
+    ScopedHandlerTimer timer(profiler.get(profileComputeDigest));
+    // Fixed-width hash over the quantized vector, see SemanticDigest.h
+    return verifier.digest(cv.data);
 }
 
-bool CoCoChainApp::verifySemanticIntegrity(const Transaction& tx)
+bool CoCoChainApp::verifySemanticIntegrity(Transaction& tx)
 {
-    if (!semanticVerification) return true;
-    
-    // Recompute semantic digest and compare
-    std::string computedDigest = computeSemanticDigest(tx.conceptVector);
-    bool isValid = (computedDigest == tx.semanticDigest);
+    ScopedHandlerTimer timer(profiler.get(profileVerify));
+    if (!verifier.isEnabled()) return true;
     
-    // Additional checks for malformed vectors
-    if (isValid) {
-        // Check for obvious corruption patterns
-        double variance = 0.0;
-        double mean = 0.0;
-        for (const auto& val : tx.conceptVector.data) {
-            mean += val;
-        }
-        mean /= tx.conceptVector.data.size();
-        
-        for (const auto& val : tx.conceptVector.data) {
-            variance += (val - mean) * (val - mean);
-        }
-        variance /= tx.conceptVector.data.size();
-        
-        // Flag as malformed if variance is too high (indicating corruption)
-        if (variance > 2.0) {
-            isValid = false;
-        }
+    // A payload seen before with the same claimed digest gets the same verdict
+    if (verifyCache.isEnabled()) {
+        int cached = verifyCache.lookup(getVerifyCacheKey(tx));
+        if (cached >= 0) return cached;
     }
     
+    // Recompute semantic digest and compare, then check for malformed
+    // vectors; with the fast digest the fingerprint already is the digest
+    bool fingerprintIsDigest = verifyCache.isEnabled() && verifier.getDigestAlgorithm() == DigestAlgorithm::FAST;
+    SemanticDigest computedDigest = fingerprintIsDigest ? tx.payloadFingerprint : computeSemanticDigest(tx.conceptVector);
+    bool isValid = computedDigest == tx.semanticDigest && verifier.checkStatistics(tx.conceptVector.data);
+    
+    if (verifyCache.isEnabled()) verifyCache.insert(tx.verifyCacheKey, isValid);
     return isValid;
 }
 
+uint64_t CoCoChainApp::getVerifyCacheKey(Transaction& tx)
+{
+    // Fingerprinted once per received transaction, on its first CPU job
+    if (!tx.hasVerifyCacheKey) {
+        const auto& data = tx.conceptVector.data;
+        tx.payloadFingerprint = computeFastDigest(data.data(), data.size());
+        tx.verifyCacheKey = VerificationCache::keyOf(tx.payloadFingerprint, tx.semanticDigest);
+        tx.hasVerifyCacheKey = true;
+    }
+    return tx.verifyCacheKey;
+}
+
 bool CoCoChainApp::isAdversarialNode()
 {
-    return adversarialNodes.count(getId()) > 0;
+    return adversarial;
 }
 
 void CoCoChainApp::injectMalformedVector(ConceptVector& cv)
@@ -364,10 +871,56 @@ void CoCoChainApp::scheduleNextMessage()
 
 void CoCoChainApp::finish()
 {
+    if (collector) {
+        collectorSummary.messagesReceived = totalMessagesReceived;
+        collectorSummary.transactionsVerified = totalTransactionsVerified;
+        collectorSummary.malformedDetected = totalMalformedDetected;
+        collectorSummary.confirmed = totalConfirmed;
+        collectorSummary.rejected = totalRejected;
+        collectorSummary.timedOut = totalTimedOut;
+        collector->reportNode(collectorSummary, latencyHistogram);
+    }
+    
     // Record final statistics
-    recordScalar("Total messages received", totalMessagesReceived);
-    recordScalar("Total malformed detected", totalMalformedDetected);
-    recordScalar("Confirmed transactions", confirmedTransactions.size());
+    if (recordNodeScalars) {
+        recordScalar("Total messages received", totalMessagesReceived);
+        recordScalar("Total malformed detected", totalMalformedDetected);
+        recordScalar("Confirmed transactions", totalConfirmed);
+        recordScalar("Rejected by consensus", totalRejected);
+        recordScalar("Total timed out", totalTimedOut);
+        consensusEngine->recordScalars(this);
+        recordScalar("Dedup filter memory", confirmedTransactions->getMemoryUsage(), "B");
+        if (cpuModel) {
+            recordScalar("CPU busy time", cpuBusyTime.dbl(), "s");
+            recordScalar("CPU utilisation", simTime() > 0 ? cpuBusyTime.dbl() / simTime().dbl() : 0.0);
+            recordScalar("CPU queue drops", totalCpuDrops);
+        }
+        if (txScheduler) {
+            recordScalar("Transmit deadline drops", totalTxDeadlineDrops);
+            recordScalar("Transmit overflow drops", totalTxOverflowDrops);
+        }
+        if (verifyCache.isEnabled()) {
+            recordScalar("Verify cache hits", verifyCache.getHits());
+            recordScalar("Verify cache misses", verifyCache.getMisses());
+        }
+        
+        // Pool blocks and table rehashes on the receive/store/vote path.
+        // Packets, chunks, concept vectors spilling out of their inline
+        // storage and tally bitsets allocate too, but are not counted here.
+        size_t growth = transactionPool.getAllocationCount() + consensusEngine->getAllocationCount() +
+                pendingTransactions.getRehashCount() + transactionStartTimes.getRehashCount();
+        recordScalar("Pool blocks and table rehashes", growth);
+        recordScalar("Pool blocks and table rehashes per received packet", totalMessagesReceived ? growth / (double)totalMessagesReceived : 0);
+    }
+    
+    // Wall-clock cost of the app's handlers (profileHandlers = true)
+    if (profiler.isEnabled()) {
+        for (const HandlerProfile& profile : profiler.getProfiles()) {
+            recordScalar((profile.name + " calls").c_str(), profile.calls);
+            recordScalar((profile.name + " wall time").c_str(), profile.nanoseconds * 1e-9, "s");
+            recordScalar((profile.name + " mean wall time").c_str(), profile.calls ? profile.nanoseconds * 1e-9 / profile.calls : 0, "s");
+        }
+    }
     
     ApplicationBase::finish();
 }
\ No newline at end of file
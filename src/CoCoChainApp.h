@@ -9,74 +9,129 @@
 #include <inet/applications/base/ApplicationBase.h>
 #include <inet/transportlayer/contract/udp/UdpSocket.h>
 #include <inet/common/packet/Packet.h>
-#include <inet/common/packet/chunk/BytesChunk.h>
-#include <map>
+#include <deque>
 #include <vector>
-#include <set>
 #include <random>
 
+#include "CoCoChainCollector.h"
+#include "CoCoChainLog.h"
+#include "CoCoChainPacket_m.h"
+#include "CoCoChainRegistry.h"
+#include "ConceptStorage.h"
+#include "ConsensusEngine.h"
+#include "DedupFilter.h"
+#include "FlatHashMap.h"
+#include "HandlerProfiler.h"
+#include "LogHistogram.h"
+#include "ObjectPool.h"
+#include "SemanticDigest.h"
+#include "SemanticVerifier.h"
+#include "SpatialIndex.h"
+#include "TokenBucket.h"
+#include "Transaction.h"
+#include "TransactionId.h"
+#include "VerificationCache.h"
+
 using namespace omnetpp;
 using namespace inet;
 
-struct ConceptVector {
-    std::vector<double> data;
-    uint64_t timestamp;
-    int nodeId;
-    bool isCorrupted;
-    
-    ConceptVector() : timestamp(0), nodeId(-1), isCorrupted(false) {}
-};
-
-struct Transaction {
-    uint64_t id;
-    ConceptVector conceptVector;
-    std::string semanticDigest;
-    uint64_t timestamp;
-    int originator;
-    bool verified;
-    
-    Transaction() : id(0), timestamp(0), originator(-1), verified(false) {}
-};
-
-struct ConsensusMessage {
-    enum Type { PROPOSE, VOTE, COMMIT };
-    Type type;
-    uint64_t transactionId;
-    int senderId;
-    bool vote; // true = accept, false = reject
-    std::string semanticDigest;
-    uint64_t timestamp;
-};
-
-class CoCoChainApp : public ApplicationBase, public UdpSocket::ICallback
+class CoCoChainApp : public ApplicationBase, public UdpSocket::ICallback, public IConsensusHost
 {
 private:
     // Parameters
     simtime_t messageInterval;
     double corruptionProbability;
     double bftThreshold;
-    bool semanticVerification;
+    int estimatedNetworkSize; // 0 = estimate from the neighbour table
+    int minRequiredVotes; // quorum floor while the neighbourhood looks small
+    int logSampleInterval; // see EV_TX
+    SemanticVerifier verifier; // semanticVerification, thresholds and digestAlgorithm
+    bool cpuModel; // received packets wait for a modelled CPU, see cpuPacketCost
+    simtime_t cpuPacketCost;
+    simtime_t cpuDigestCost;
+    simtime_t cpuSignatureCost;
+    simtime_t cpuVoteCost;
+    int cpuQueueLength; // 0 = unbounded
+    bool txScheduler; // outgoing packets queued and paced, see txRate
+    double txRate; // packets/s while the channel is below targetBusyRatio
+    double txMinRate;
+    double targetBusyRatio;
+    double channelBitrate; // bit/s, to turn heard bytes into airtime
+    simtime_t busyRatioWindow;
+    int txQueueLength; // per queue; 0 = unbounded
+    VerificationCache verifyCache; // verdicts by payload and digest, see verifyCacheSize
+    simtime_t verifyBatchWindow; // 0 = verify each transaction on arrival
+    int verifyBatchSize;
     simtime_t maxTransactionAge;
+    simtime_t gcInterval;
+    bool transmitConceptVector;
+    int conceptDimensions;
+    ConceptEncoding conceptEncoding;
     
     // Network
     UdpSocket socket;
     int localPort;
+    CoCoChainRegistry *registry; // nullptr = partition-local indexing, see registryModule
+    int nodeIndex; // dense index assigned by the registry, or the vehicle index
+    int numNodes; // size of the vehicle vector when running without a registry
+    bool adversarial;
     
     // CoCoChain state
-    std::map<uint64_t, Transaction> pendingTransactions;
-    std::map<uint64_t, std::vector<ConsensusMessage>> consensusVotes;
-    std::set<uint64_t> confirmedTransactions;
-    std::set<int> adversarialNodes;
+    // Pending transactions are pooled; the table holds pointers
+    ObjectPool<Transaction> transactionPool;
+    FlatHashMap<Transaction*> pendingTransactions;
+    IConsensusEngine *consensusEngine; // voting and tallying, see consensusMode
+    
+    // Neighbour table: node index -> last time we overheard it, aged by
+    // maxTransactionAge in the GC sweep
+    FlatHashMap<simtime_t> neighbourLastHeard;
+    
+    // Optional position-based neighbour source ("spatial")
+    SpatialIndex *spatialIndex;
+    IMobility *mobility;
+    double communicationRange;
+    IDedupFilter *confirmedTransactions;
     
     // Statistics
     simsignal_t endToEndLatencySignal;
+    simsignal_t endToEndLatencySampleSignal;
     simsignal_t consensusOverheadSignal;
     simsignal_t malformedDetectedSignal;
+    simsignal_t timedOutSignal;
+    simsignal_t neighbourCountSignal;
+    simsignal_t hopDelaySignal;
+    simsignal_t pendingDepthSignal;
+    simsignal_t cpuQueueingDelaySignal;
+    simsignal_t cpuDropSignal;
+    simsignal_t txQueueingDelaySignal;
+    simsignal_t txDropSignal;
+    simsignal_t channelBusyRatioSignal;
     
     // Metrics tracking
-    std::map<uint64_t, simtime_t> transactionStartTimes;
+    FlatHashMap<simtime_t> transactionStartTimes;
     int totalMessagesReceived;
+    int totalTransactionsVerified;
     int totalMalformedDetected;
+    int totalConfirmed;
+    int totalTimedOut;
+    int totalRejected;
+    int latencySampleInterval; // 0 = no latency vector
+    long latenciesMeasured;
+    
+    // Network-wide statistics, reported once from finish()
+    CoCoChainCollector *collector; // nullptr = collectorModule is empty
+    bool recordNodeScalars;
+    NodeSummary collectorSummary; // ground-truth counters; the rest is filled in finish()
+    LogHistogram latencyHistogram;
+    
+    // Wall-clock profiling of handlers, see profileHandlers
+    HandlerProfiler profiler;
+    int profileSocketDataArrived;
+    int profileSendTransaction;
+    int profileComputeDigest;
+    int profileVerify;
+    int profileConsensus;
+    int profileExpireTransactions;
     
     // Random number generation
     std::mt19937 rng;
@@ -85,6 +140,47 @@ private:
     
     // Message handling
     cMessage *sendTimer;
+    cMessage *gcTimer;
+    
+    // Received transactions waiting for the next batch verification; batch
+    // holds their concept vectors in the same order
+    std::vector<Transaction*> verifyQueue;
+    ConceptBatch verifyBatch;
+    std::vector<uint8_t> verifyVerdicts;
+    cMessage *verifyBatchTimer;
+    
+    // Modelled CPU: received packets are served one at a time in arrival
+    // order; the front job is in service until cpuTimer fires
+    struct CpuJob {
+        Packet *packet;
+        Transaction *tx; // decoded at service start (TRANSACTION only)
+        simtime_t enqueuedAt;
+    };
+    std::deque<CpuJob> cpuQueue;
+    cMessage *cpuTimer;
+    simtime_t cpuBusyTime;
+    int totalCpuDrops;
+    
+    // Transmit scheduler: votes (and COMMITs) are sent before transactions,
+    // paced by a token bucket whose rate shrinks as the channel busy ratio
+    // exceeds targetBusyRatio; packets past their deadline are dropped.
+    // Each queue is kept in deadline order, earliest first.
+    struct TxJob {
+        Packet *packet;
+        L3Address destAddr;
+        simtime_t enqueuedAt;
+        simtime_t deadline;
+    };
+    std::deque<TxJob> voteTxQueue;
+    std::deque<TxJob> transactionTxQueue;
+    TokenBucket txBucket;
+    cMessage *txTimer;
+    // Busy ratio estimated from the airtime of packets heard and sent
+    double channelBusyRatio;
+    simtime_t busyWindowStart;
+    simtime_t busyWindowAirtime;
+    int totalTxDeadlineDrops;
+    int totalTxOverflowDrops;
     uint64_t transactionCounter;
     
 protected:
@@ -99,16 +195,40 @@ protected:
     
     // CoCoChain functionality
     void sendTransaction();
-    void processReceivedTransaction(const Transaction& tx);
-    void startConsensus(const Transaction& tx);
-    void processConsensusMessage(const ConsensusMessage& msg);
-    void finalizeTransaction(uint64_t txId);
+    void noteSender(Packet *packet); // neighbour table and hop delay, at arrival
+    void noteHeard(int nodeIndex, uint64_t sentAt); // a packet sent by nodeIndex at sentAt (us) was received
+    void processPacket(Packet *packet, Transaction *tx); // tx = packet already decoded, or nullptr
+    Transaction *decodeTransaction(Packet *packet); // into a pooled transaction
+    void enqueueCpuJob(Packet *packet);
+    void startCpuJob();
+    void transmit(Packet *packet, const L3Address& destAddr, bool isVote, simtime_t deadline);
+    void sendQueuedPackets();
+    void dropExpiredTxJobs(std::deque<TxJob>& queue, simtime_t now);
+    void noteAirtime(const Packet *packet);
+    void processReceivedTransaction(Transaction *tx); // takes ownership of a pooled transaction
+    void processVerifiedTransaction(Transaction *tx, bool isValid); // likewise
+    void flushVerifyBatch();
+    void dropPendingTransaction(uint64_t txId);
+    void expireTransactions();
+    
+    // IConsensusHost
+    virtual int getHostId() const override { return getId(); }
+    virtual int getHostIndex() const override { return nodeIndex; }
+    virtual int getNumNodes() const override { return registry ? registry->getNumNodes() : numNodes; }
+    virtual int getNeighbourhoodSize() const override;
+    virtual int getRequiredVotes() const override;
+    virtual int getMinRequiredVotes() const override { return minRequiredVotes; }
+    virtual int getLogSampleInterval() const override { return logSampleInterval; }
+    virtual void sendConsensusPacket(Packet *packet, const L3Address& destAddr, uint64_t transactionTimestamp) override;
+    virtual void finalizeTransaction(uint64_t txId) override;
+    virtual void rejectTransaction(uint64_t txId) override;
     
     // Concept corruption and verification
-    ConceptVector generateConceptVector();
+    void generateConceptVector(ConceptVector& cv);
     void corruptConceptVector(ConceptVector& cv);
-    std::string computeSemanticDigest(const ConceptVector& cv);
-    bool verifySemanticIntegrity(const Transaction& tx);
+    SemanticDigest computeSemanticDigest(const ConceptVector& cv);
+    bool verifySemanticIntegrity(Transaction& tx);
+    uint64_t getVerifyCacheKey(Transaction& tx);
     
     // Adversarial behavior
     bool isAdversarialNode();
@@ -0,0 +1,75 @@
+//
+// CoCoChain Network Statistics Collector Implementation
+//
+
+#include "CoCoChainCollector.h"
+#include "LogHistogramRecorder.h"
+
+Define_Module(CoCoChainCollector);
+
+CoCoChainCollector::CoCoChainCollector() :
+    registeredNodes(0),
+    reportedNodes(0),
+    recorded(false)
+{
+}
+
+void CoCoChainCollector::initialize()
+{
+    WATCH(registeredNodes);
+    WATCH(reportedNodes);
+}
+
+void CoCoChainCollector::handleMessage(cMessage *)
+{
+    throw cRuntimeError("CoCoChainCollector does not process messages");
+}
+
+void CoCoChainCollector::finish()
+{
+    // Apps whose finish() has not run yet trigger the record themselves
+    if (reportedNodes == registeredNodes) recordSummary();
+}
+
+void CoCoChainCollector::registerNode()
+{
+    Enter_Method_Silent();
+    registeredNodes++;
+}
+
+void CoCoChainCollector::reportNode(const NodeSummary& summary, const LogHistogram& nodeLatency)
+{
+    Enter_Method_Silent();
+    totals.messagesReceived += summary.messagesReceived;
+    totals.transactionsVerified += summary.transactionsVerified;
+    totals.malformedDetected += summary.malformedDetected;
+    totals.confirmed += summary.confirmed;
+    totals.rejected += summary.rejected;
+    totals.timedOut += summary.timedOut;
+    totals.adversarialVerified += summary.adversarialVerified;
+    totals.adversarialDetected += summary.adversarialDetected;
+    totals.honestVerified += summary.honestVerified;
+    totals.honestDetected += summary.honestDetected;
+    latency.merge(nodeLatency);
+    if (++reportedNodes == registeredNodes) recordSummary();
+}
+
+void CoCoChainCollector::recordSummary()
+{
+    if (recorded) return;
+    recorded = true;
+
+    recordScalar("Nodes", reportedNodes);
+    recordScalar("Messages received", totals.messagesReceived);
+    recordScalar("Transactions verified", totals.transactionsVerified);
+    recordScalar("Malformed detected", totals.malformedDetected);
+    recordScalar("Detection rate", totals.transactionsVerified ? totals.malformedDetected / (double)totals.transactionsVerified : 0);
+    recordScalar("Confirmations", totals.confirmed);
+    recordScalar("Rejected by consensus", totals.rejected);
+    recordScalar("Timed out", totals.timedOut);
+    if (totals.adversarialVerified + totals.honestVerified > 0) {
+        recordScalar("Adversarial detection rate", totals.adversarialVerified ? totals.adversarialDetected / (double)totals.adversarialVerified : 0);
+        recordScalar("Honest rejection rate", totals.honestVerified ? totals.honestDetected / (double)totals.honestVerified : 0);
+    }
+    recordLogHistogram(this, "endToEndLatency", latency);
+}
@@ -0,0 +1,59 @@
+//
+// CoCoChain Network Statistics Collector
+//
+
+#ifndef __COCOCHAIN_COCOCHAINCOLLECTOR_H_
+#define __COCOCHAIN_COCOCHAINCOLLECTOR_H_
+
+#include <omnetpp.h>
+
+#include "LogHistogram.h"
+
+using namespace omnetpp;
+
+// Per-node counters handed to the collector once, from the app's finish()
+struct NodeSummary {
+    long messagesReceived;
+    long transactionsVerified;
+    long malformedDetected;
+    long confirmed;
+    long rejected; // rejected by consensus
+    long timedOut;
+    // Ground truth by originator, only counted when a registry is in use
+    long adversarialVerified;
+    long adversarialDetected;
+    long honestVerified;
+    long honestDetected;
+
+    NodeSummary() : messagesReceived(0), transactionsVerified(0), malformedDetected(0), confirmed(0), rejected(0),
+        timedOut(0), adversarialVerified(0), adversarialDetected(0), honestVerified(0), honestDetected(0) {}
+};
+
+// Network-wide totals and the merged confirmation-latency histogram, written
+// as one compact record per run instead of per-node scalars. Apps register
+// in initialize() and report from finish(); the record is written once all
+// registered apps have reported, whichever finish() runs last.
+class CoCoChainCollector : public cSimpleModule
+{
+private:
+    int registeredNodes;
+    int reportedNodes;
+    bool recorded;
+    NodeSummary totals;
+    LogHistogram latency;
+
+    void recordSummary();
+
+protected:
+    virtual void initialize() override;
+    virtual void handleMessage(cMessage *msg) override;
+    virtual void finish() override;
+
+public:
+    CoCoChainCollector();
+
+    void registerNode();
+    void reportNode(const NodeSummary& summary, const LogHistogram& nodeLatency);
+};
+
+#endif
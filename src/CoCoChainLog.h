@@ -0,0 +1,52 @@
+//
+// CoCoChain Logging
+//
+
+#ifndef __COCOCHAIN_COCOCHAINLOG_H_
+#define __COCOCHAIN_COCOCHAINLOG_H_
+
+#include <omnetpp.h>
+
+#include "TransactionId.h"
+
+// Compile-time level of CoCoChain's own logging, independent of
+// OMNeT++'s COMPILETIME_LOGLEVEL (e.g. -DCOCOCHAIN_LOG_LEVEL=1):
+//   0  nothing
+//   1  configuration and per-sweep summaries
+//   2  one line per transaction, vote and batch (the hot path)
+// Release builds (NDEBUG) default to 1, so per-packet logging is compiled
+// out of production sweeps.
+#define COCOCHAIN_LOG_NONE 0
+#define COCOCHAIN_LOG_SUMMARY 1
+#define COCOCHAIN_LOG_PACKETS 2
+
+#ifndef COCOCHAIN_LOG_LEVEL
+#ifdef NDEBUG
+#define COCOCHAIN_LOG_LEVEL COCOCHAIN_LOG_SUMMARY
+#else
+#define COCOCHAIN_LOG_LEVEL COCOCHAIN_LOG_PACKETS
+#endif
+#endif
+
+// Log only transactions whose sequence number is a multiple of
+// sampleInterval (the module's logSampleInterval parameter), so one
+// transaction is followed on every node it reaches. 1 logs every transaction.
+inline bool isCocochainTransactionLogged(uint64_t txId, int sampleInterval)
+{
+    return omnetpp::getEnvir()->isLoggingEnabled() && transactionSequence(txId) % sampleInterval == 0;
+}
+
+// Per-packet log line about one transaction:
+// EV_TX(txId, logSampleInterval) << ... << endl;
+#define EV_TX(txId, sampleInterval) \
+    if (COCOCHAIN_LOG_LEVEL < COCOCHAIN_LOG_PACKETS || !isCocochainTransactionLogged(txId, sampleInterval)) ; else EV_INFO
+
+// Per-packet log line not tied to one transaction
+#define EV_PACKET \
+    if (COCOCHAIN_LOG_LEVEL < COCOCHAIN_LOG_PACKETS || !omnetpp::getEnvir()->isLoggingEnabled()) ; else EV_INFO
+
+// Rare events and summaries
+#define EV_SUMMARY \
+    if (COCOCHAIN_LOG_LEVEL < COCOCHAIN_LOG_SUMMARY) ; else EV_INFO
+
+#endif
@@ -0,0 +1,35 @@
+//
+// CoCoChain Node Registry Implementation
+//
+
+#include "CoCoChainRegistry.h"
+
+Define_Module(CoCoChainRegistry);
+
+void CoCoChainRegistry::handleMessage(cMessage *)
+{
+    throw cRuntimeError("CoCoChainRegistry does not process messages");
+}
+
+void CoCoChainRegistry::finish()
+{
+    recordScalar("Registered nodes", getNumNodes());
+    recordScalar("Adversarial nodes", getNumAdversarial());
+}
+
+int CoCoChainRegistry::registerNode(int moduleId, bool isAdversarial)
+{
+    Enter_Method_Silent();
+    int nodeIndex = getNumNodes();
+    moduleIds.push_back(moduleId);
+    if (nodeIndex % 64 == 0) adversarial.push_back(0);
+    if (isAdversarial) adversarial.back() |= 1ULL << (nodeIndex % 64);
+    return nodeIndex;
+}
+
+int CoCoChainRegistry::getNumAdversarial() const
+{
+    int count = 0;
+    for (uint64_t word : adversarial) count += __builtin_popcountll(word);
+    return count;
+}
@@ -0,0 +1,40 @@
+//
+// CoCoChain Node Registry
+//
+
+#ifndef __COCOCHAIN_COCOCHAINREGISTRY_H_
+#define __COCOCHAIN_COCOCHAINREGISTRY_H_
+
+#include <omnetpp.h>
+#include <cstdint>
+#include <vector>
+
+using namespace omnetpp;
+
+// Simulation-wide directory of CoCoChain nodes. Apps register in
+// INITSTAGE_LOCAL and get a dense index 0..N-1 in registration order; the
+// index names the node in transaction IDs, voter bitsets and dedup
+// windows. Adversarial flags are kept in one bitset indexed the same way.
+// Registration does not depend on this module having been initialized.
+class CoCoChainRegistry : public cSimpleModule
+{
+private:
+    std::vector<int> moduleIds; // dense index -> app module ID
+    std::vector<uint64_t> adversarial;
+
+protected:
+    virtual void handleMessage(cMessage *msg) override;
+    virtual void finish() override;
+
+public:
+    int registerNode(int moduleId, bool isAdversarial);
+
+    bool isAdversarial(int nodeIndex) const {
+        return (adversarial[nodeIndex / 64] >> (nodeIndex % 64)) & 1;
+    }
+    int getModuleId(int nodeIndex) const { return moduleIds[nodeIndex]; }
+    int getNumNodes() const { return static_cast<int>(moduleIds.size()); }
+    int getNumAdversarial() const;
+};
+
+#endif
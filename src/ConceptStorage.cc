@@ -0,0 +1,44 @@
+//
+// CoCoChain Concept Vector Storage Implementation
+//
+
+#include "ConceptStorage.h"
+#include <cmath>
+
+size_t getEncodedConceptLength(ConceptEncoding encoding, size_t dimensions)
+{
+    switch (encoding) {
+        case ConceptEncoding::FLOAT32: return 4 * dimensions;
+        case ConceptEncoding::INT8: return sizeof(float) + dimensions;
+        case ConceptEncoding::FLOAT64:
+        default: return 8 * dimensions;
+    }
+}
+
+void quantizeConcept(ConceptScalar *data, size_t size, ConceptEncoding encoding)
+{
+    switch (encoding) {
+        case ConceptEncoding::FLOAT32:
+            for (size_t i = 0; i < size; i++) {
+                data[i] = static_cast<float>(data[i]);
+            }
+            break;
+        case ConceptEncoding::INT8: {
+            double maxAbs = 0;
+            for (size_t i = 0; i < size; i++) {
+                maxAbs = std::max(maxAbs, std::fabs(static_cast<double>(data[i])));
+            }
+            float scale = static_cast<float>(maxAbs / 127.0);
+            if (scale == 0) break;
+            for (size_t i = 0; i < size; i++) {
+                long q = std::lround(data[i] / scale);
+                q = std::max(-127L, std::min(127L, q));
+                data[i] = static_cast<ConceptScalar>(q * static_cast<double>(scale));
+            }
+            break;
+        }
+        case ConceptEncoding::FLOAT64:
+        default:
+            break;
+    }
+}
@@ -0,0 +1,114 @@
+//
+// CoCoChain Concept Vector Storage
+//
+
+#ifndef __COCOCHAIN_CONCEPTSTORAGE_H_
+#define __COCOCHAIN_CONCEPTSTORAGE_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <algorithm>
+#include <utility>
+
+// Inline capacity and element type of concept vectors, fixed at compile
+// time (e.g. -DCOCOCHAIN_CONCEPT_INLINE_DIMS=64 -DCOCOCHAIN_CONCEPT_FLOAT).
+// Vectors up to the inline capacity need no heap allocation; larger
+// conceptDimensions still work through the heap fallback.
+#ifndef COCOCHAIN_CONCEPT_INLINE_DIMS
+#define COCOCHAIN_CONCEPT_INLINE_DIMS 16
+#endif
+
+#ifdef COCOCHAIN_CONCEPT_FLOAT
+typedef float ConceptScalar;
+#else
+typedef double ConceptScalar;
+#endif
+
+// Vector with N elements of inline storage and a heap fallback beyond that
+template <typename T, size_t N>
+class InlineVector
+{
+private:
+    T inlineData[N];
+    T *heapData;
+    size_t count;
+    size_t heapCapacity;
+
+    void assign(const InlineVector& other) {
+        resize(other.count);
+        std::copy(other.data(), other.data() + other.count, data());
+    }
+
+public:
+    InlineVector() : heapData(nullptr), count(0), heapCapacity(0) {}
+    InlineVector(const InlineVector& other) : heapData(nullptr), count(0), heapCapacity(0) { assign(other); }
+    InlineVector(InlineVector&& other) noexcept : heapData(nullptr), count(0), heapCapacity(0) { *this = std::move(other); }
+    ~InlineVector() { delete[] heapData; }
+
+    InlineVector& operator=(const InlineVector& other) {
+        if (this != &other) assign(other);
+        return *this;
+    }
+
+    InlineVector& operator=(InlineVector&& other) noexcept {
+        if (this == &other) return *this;
+        if (other.heapData) {
+            delete[] heapData;
+            heapData = other.heapData;
+            heapCapacity = other.heapCapacity;
+            count = other.count;
+            other.heapData = nullptr;
+            other.heapCapacity = 0;
+        }
+        else {
+            assign(other);
+        }
+        other.count = 0;
+        return *this;
+    }
+
+    // New elements are zero-initialized
+    void resize(size_t n) {
+        if (n > capacity()) {
+            T *grown = new T[n];
+            std::copy(data(), data() + count, grown);
+            delete[] heapData;
+            heapData = grown;
+            heapCapacity = n;
+        }
+        if (n > count) std::fill(data() + count, data() + n, T());
+        count = n;
+    }
+
+    bool isInline() const { return heapData == nullptr; }
+    size_t capacity() const { return heapData ? heapCapacity : N; }
+    size_t size() const { return count; }
+    bool empty() const { return count == 0; }
+
+    T *data() { return heapData ? heapData : inlineData; }
+    const T *data() const { return heapData ? heapData : inlineData; }
+    T& operator[](size_t i) { return data()[i]; }
+    const T& operator[](size_t i) const { return data()[i]; }
+    T *begin() { return data(); }
+    T *end() { return data() + count; }
+    const T *begin() const { return data(); }
+    const T *end() const { return data() + count; }
+};
+
+typedef InlineVector<ConceptScalar, COCOCHAIN_CONCEPT_INLINE_DIMS> ConceptStorage;
+
+// On-air representation of the concept vector
+enum class ConceptEncoding : uint8_t {
+    FLOAT64 = 0,
+    FLOAT32 = 1,
+    INT8 = 2 // symmetric per-vector scale (float) + one signed byte per dimension
+};
+
+// Bytes the vector occupies in a transaction packet
+size_t getEncodedConceptLength(ConceptEncoding encoding, size_t dimensions);
+
+// Rounds values in place to what the encoding can represent, so that the
+// sender's digest matches the values a receiver decodes
+void quantizeConcept(ConceptScalar *data, size_t size, ConceptEncoding encoding);
+
+#endif
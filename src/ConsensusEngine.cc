@@ -0,0 +1,425 @@
+//
+// CoCoChain Consensus Engines Implementation
+//
+
+#include "ConsensusEngine.h"
+#include "CoCoChainLog.h"
+#include "GossipQuorum.h"
+#include <algorithm>
+#include <cmath>
+
+//
+// TallyingConsensusEngine
+//
+
+TallyingConsensusEngine::TallyingConsensusEngine(IConsensusHost& host, cSimpleModule *module) :
+    host(host),
+    module(module)
+{
+    timeToFirstVoteSignal = cComponent::registerSignal("timeToFirstVote");
+    timeToQuorumSignal = cComponent::registerSignal("timeToQuorum");
+}
+
+VoteTally& TallyingConsensusEngine::openVoteTally(uint64_t txId)
+{
+    auto entry = consensusVotes.open(txId, host.getNumNodes(), simTime().inUnit(SIMTIME_US));
+    if (entry.second)
+        entry.first->setRequiredVotes(scaleQuorum(host.getRequiredVotes()));
+    return *entry.first;
+}
+
+void TallyingConsensusEngine::dropVoteTally(uint64_t txId)
+{
+    consensusVotes.drop(txId);
+}
+
+VoteTally *TallyingConsensusEngine::countVote(const ConsensusMessage& vote)
+{
+    VoteTally& tally = openVoteTally(vote.transactionId);
+    if (!tally.addVote(vote.senderIndex, vote.vote)) return nullptr;
+    bool quorum = tally.hasQuorum();
+
+    // Stage latencies of our own transactions, whose tally opened when we sent them
+    if (tally.isLocal()) {
+        simtime_t elapsed = simTime() - SimTime(tally.getOpenedAt(), SIMTIME_US);
+        if (tally.getTotalVotes() == 1) module->emit(timeToFirstVoteSignal, elapsed.dbl());
+        if (quorum) module->emit(timeToQuorumSignal, elapsed.dbl());
+    }
+    return quorum ? &tally : nullptr;
+}
+
+ConsensusMessage TallyingConsensusEngine::makeVote(const Transaction& tx)
+{
+    ConsensusMessage vote;
+    vote.type = ConsensusMessage::VOTE;
+    vote.transactionId = tx.id;
+    vote.senderId = host.getHostId();
+    vote.senderIndex = host.getHostIndex();
+    vote.vote = tx.verified; // Verified once by the host before storing
+    vote.timestamp = simTime().inUnit(SIMTIME_US);
+    return vote;
+}
+
+void TallyingConsensusEngine::startConsensus(const Transaction& tx, int requiredVotes)
+{
+    // Snapshot the quorum, even if early votes already opened the tally
+    openVoteTally(tx.id).setRequiredVotes(scaleQuorum(requiredVotes));
+}
+
+void TallyingConsensusEngine::trackTransaction(uint64_t txId, int requiredVotes)
+{
+    VoteTally& tally = openVoteTally(txId);
+    tally.setRequiredVotes(scaleQuorum(requiredVotes));
+    tally.setLocal(true);
+}
+
+void TallyingConsensusEngine::expire(uint64_t cutoff)
+{
+    consensusVotes.expire(cutoff);
+}
+
+//
+// BroadcastConsensusEngine
+//
+
+BroadcastConsensusEngine::BroadcastConsensusEngine(IConsensusHost& host, cSimpleModule *module, simtime_t voteBatchWindow, int voteBatchSize) :
+    TallyingConsensusEngine(host, module),
+    voteBatchWindow(voteBatchWindow),
+    voteBatchSize(voteBatchSize),
+    voteBatchBitmap(0),
+    voteBatchNewest(0)
+{
+    voteBatchTimer = new cMessage("voteBatchTimer");
+    voteBatchIds.reserve(voteBatchSize);
+}
+
+BroadcastConsensusEngine::~BroadcastConsensusEngine()
+{
+    module->cancelAndDelete(voteBatchTimer);
+}
+
+void BroadcastConsensusEngine::startConsensus(const Transaction& tx, int requiredVotes)
+{
+    TallyingConsensusEngine::startConsensus(tx, requiredVotes);
+    castVote(tx);
+}
+
+void BroadcastConsensusEngine::castVote(const Transaction& tx)
+{
+    ConsensusMessage vote = makeVote(tx);
+    if (voteBatchWindow > 0)
+        queueVote(vote, tx.timestamp);
+    else
+        sendVote(vote, tx.timestamp);
+}
+
+void BroadcastConsensusEngine::sendVote(const ConsensusMessage& vote, uint64_t transactionTimestamp)
+{
+    auto consensusPacket = makeShared<CoCoChainConsensusPacket>();
+    consensusPacket->setConsensusType(vote.type);
+    consensusPacket->setTransactionId(vote.transactionId);
+    consensusPacket->setSenderId(vote.senderId);
+    consensusPacket->setSenderIndex(vote.senderIndex);
+    consensusPacket->setVote(vote.vote);
+    consensusPacket->setTimestamp(vote.timestamp);
+
+    host.sendConsensusPacket(new Packet("CoCoChainConsensus", consensusPacket), Ipv4Address::ALLONES_ADDRESS, transactionTimestamp);
+
+    EV_TX(vote.transactionId, host.getLogSampleInterval()) << "Sent " << (vote.vote ? "positive" : "negative") << " vote for transaction " << vote.transactionId << endl;
+}
+
+void BroadcastConsensusEngine::queueVote(const ConsensusMessage& vote, uint64_t transactionTimestamp)
+{
+    // The first vote of a batch opens the window; a full batch goes out early
+    if (voteBatchIds.empty()) {
+        module->scheduleAt(simTime() + voteBatchWindow, voteBatchTimer);
+    }
+    if (vote.vote) {
+        voteBatchBitmap |= 1ULL << voteBatchIds.size();
+    }
+    voteBatchIds.push_back(vote.transactionId);
+    voteBatchNewest = std::max(voteBatchNewest, transactionTimestamp);
+
+    if ((int)voteBatchIds.size() >= voteBatchSize) {
+        module->cancelEvent(voteBatchTimer);
+        flushVoteBatch();
+    }
+}
+
+void BroadcastConsensusEngine::flushVoteBatch()
+{
+    if (voteBatchIds.empty()) return;
+
+    auto batchPacket = makeShared<CoCoChainVoteBatchPacket>();
+    batchPacket->setSenderId(host.getHostId());
+    batchPacket->setSenderIndex(host.getHostIndex());
+    batchPacket->setTimestamp(simTime().inUnit(SIMTIME_US));
+    batchPacket->setTransactionIdsArraySize(voteBatchIds.size());
+    for (size_t i = 0; i < voteBatchIds.size(); i++) {
+        batchPacket->setTransactionIds(i, voteBatchIds[i]);
+    }
+    batchPacket->setVoteBitmap(voteBatchBitmap);
+    batchPacket->setChunkLength(COCOCHAIN_VOTE_BATCH_HEADER_LENGTH + B(8 * voteBatchIds.size() + (voteBatchIds.size() + 7) / 8));
+
+    host.sendConsensusPacket(new Packet("CoCoChainVoteBatch", batchPacket), Ipv4Address::ALLONES_ADDRESS, voteBatchNewest);
+
+    EV_PACKET << "Sent batch of " << voteBatchIds.size() << " votes" << endl;
+
+    voteBatchIds.clear();
+    voteBatchBitmap = 0;
+    voteBatchNewest = 0;
+}
+
+void BroadcastConsensusEngine::processVote(const ConsensusMessage& vote)
+{
+    if (vote.type != ConsensusMessage::VOTE) return;
+
+    VoteTally *tally = countVote(vote);
+    if (!tally) return;
+
+    if (tally->getAcceptVotes() >= tally->getRequiredVotes()) {
+        host.finalizeTransaction(vote.transactionId);
+    }
+    else {
+        // Transaction rejected by consensus
+        host.rejectTransaction(vote.transactionId);
+        EV_TX(vote.transactionId, host.getLogSampleInterval()) << "Transaction " << vote.transactionId << " rejected by consensus" << endl;
+    }
+    dropVoteTally(vote.transactionId);
+}
+
+bool BroadcastConsensusEngine::handlePacket(Packet *packet, CoCoChainMessageType type)
+{
+    switch (type) {
+        case COCOCHAIN_CONSENSUS: {
+            const auto& consensusPacket = packet->peekAtFront<CoCoChainConsensusPacket>();
+            ConsensusMessage msg;
+            msg.type = static_cast<ConsensusMessage::Type>(consensusPacket->getConsensusType());
+            msg.transactionId = consensusPacket->getTransactionId();
+            msg.senderId = consensusPacket->getSenderId();
+            msg.senderIndex = consensusPacket->getSenderIndex();
+            msg.vote = consensusPacket->getVote();
+            msg.timestamp = consensusPacket->getTimestamp();
+
+            processVote(msg);
+            return true;
+        }
+        case COCOCHAIN_VOTE_BATCH: {
+            const auto& batchPacket = packet->peekAtFront<CoCoChainVoteBatchPacket>();
+            ConsensusMessage msg;
+            msg.type = ConsensusMessage::VOTE;
+            msg.senderId = batchPacket->getSenderId();
+            msg.senderIndex = batchPacket->getSenderIndex();
+            msg.timestamp = batchPacket->getTimestamp();
+            uint64_t bitmap = batchPacket->getVoteBitmap();
+
+            size_t count = batchPacket->getTransactionIdsArraySize();
+            for (size_t i = 0; i < count; i++) {
+                msg.transactionId = batchPacket->getTransactionIds(i);
+                msg.vote = (bitmap >> i) & 1;
+                processVote(msg);
+            }
+            return true;
+        }
+        default:
+            return false;
+    }
+}
+
+bool BroadcastConsensusEngine::handleTimer(cMessage *msg)
+{
+    if (msg != voteBatchTimer) return false;
+    flushVoteBatch();
+    return true;
+}
+
+//
+// GossipConsensusEngine
+//
+
+GossipConsensusEngine::GossipConsensusEngine(IConsensusHost& host, cSimpleModule *module, simtime_t voteBatchWindow, int voteBatchSize, double coverage, int fanout) :
+    BroadcastConsensusEngine(host, module, voteBatchWindow, voteBatchSize),
+    coverage(coverage),
+    fanout(fanout),
+    votesCast(0),
+    votesSkipped(0)
+{
+}
+
+int GossipConsensusEngine::getMinQuorum() const
+{
+    return std::max(fanout, host.getMinRequiredVotes());
+}
+
+double GossipConsensusEngine::getVoteProbability() const
+{
+    return GossipQuorum::voteProbability(host.getNeighbourhoodSize(), coverage, host.getRequiredVotes(), getMinQuorum());
+}
+
+int GossipConsensusEngine::scaleQuorum(int requiredVotes) const
+{
+    return GossipQuorum::quorum(getVoteProbability(), requiredVotes, getMinQuorum());
+}
+
+void GossipConsensusEngine::startConsensus(const Transaction& tx, int requiredVotes)
+{
+    TallyingConsensusEngine::startConsensus(tx, requiredVotes);
+    if (module->uniform(0, 1) < getVoteProbability()) {
+        castVote(tx);
+        votesCast++;
+    }
+    else {
+        votesSkipped++;
+    }
+}
+
+void GossipConsensusEngine::recordScalars(cComponent *component)
+{
+    component->recordScalar("Gossip votes cast", votesCast);
+    component->recordScalar("Gossip votes skipped", votesSkipped);
+}
+
+//
+// AggregatedConsensusEngine
+//
+
+AggregatedConsensusEngine::AggregatedConsensusEngine(IConsensusHost& host, cSimpleModule *module, simtime_t aggregateVerifyDelay, simtime_t aggregateKeyDelay) :
+    TallyingConsensusEngine(host, module),
+    aggregateVerifyDelay(aggregateVerifyDelay),
+    aggregateKeyDelay(aggregateKeyDelay),
+    totalCommitsSent(0)
+{
+    commitTimer = new cMessage("commitTimer");
+}
+
+AggregatedConsensusEngine::~AggregatedConsensusEngine()
+{
+    module->cancelAndDelete(commitTimer);
+}
+
+void AggregatedConsensusEngine::startConsensus(const Transaction& tx, int)
+{
+    // Only the originator tallies, so no tally is opened here
+    ConsensusMessage vote = makeVote(tx);
+
+    auto consensusPacket = makeShared<CoCoChainConsensusPacket>();
+    consensusPacket->setConsensusType(vote.type);
+    consensusPacket->setTransactionId(vote.transactionId);
+    consensusPacket->setSenderId(vote.senderId);
+    consensusPacket->setSenderIndex(vote.senderIndex);
+    consensusPacket->setVote(vote.vote);
+    consensusPacket->setTimestamp(vote.timestamp);
+
+    host.sendConsensusPacket(new Packet("CoCoChainConsensus", consensusPacket), tx.originatorAddress, tx.timestamp);
+
+    EV_TX(tx.id, host.getLogSampleInterval()) << "Sent " << (vote.vote ? "positive" : "negative") << " vote for transaction " << tx.id << " to its originator" << endl;
+}
+
+void AggregatedConsensusEngine::sendCommit(uint64_t txId, const VoteTally& tally, bool accepted)
+{
+    const auto& voters = tally.getVoters();
+    auto commitPacket = makeShared<CoCoChainCommitPacket>();
+    commitPacket->setTransactionId(txId);
+    commitPacket->setSenderId(host.getHostId());
+    commitPacket->setSenderIndex(host.getHostIndex());
+    commitPacket->setAccepted(accepted);
+    commitPacket->setTimestamp(simTime().inUnit(SIMTIME_US));
+    commitPacket->setVoterBitmapArraySize(voters.size());
+    for (size_t i = 0; i < voters.size(); i++) {
+        commitPacket->setVoterBitmap(i, voters[i]);
+    }
+    commitPacket->setChunkLength(COCOCHAIN_COMMIT_HEADER_LENGTH + B(8 * voters.size()));
+
+    // Our own transaction, whose tally opened when we sent it
+    host.sendConsensusPacket(new Packet("CoCoChainCommit", commitPacket), Ipv4Address::ALLONES_ADDRESS, tally.getOpenedAt());
+    totalCommitsSent++;
+
+    EV_TX(txId, host.getLogSampleInterval()) << "Sent " << (accepted ? "accepting" : "rejecting") << " COMMIT for transaction " << txId
+            << " with " << tally.getTotalVotes() << " votes" << endl;
+}
+
+void AggregatedConsensusEngine::processCommit(const CoCoChainCommitPacket& commit)
+{
+    // Model the BLS check: a fixed pairing cost plus aggregating one public
+    // key per signer. Checks run one after another on this node's CPU.
+    int signers = 0;
+    for (size_t i = 0; i < commit.getVoterBitmapArraySize(); i++) {
+        signers += __builtin_popcountll(commit.getVoterBitmap(i));
+    }
+    simtime_t start = commitQueue.empty() ? simTime() : std::max(simTime(), commitQueue.back().readyAt);
+
+    PendingCommit pending;
+    pending.readyAt = start + aggregateVerifyDelay + aggregateKeyDelay * signers;
+    pending.transactionId = commit.getTransactionId();
+    pending.accepted = commit.getAccepted();
+    commitQueue.push_back(pending);
+
+    if (!commitTimer->isScheduled()) {
+        module->scheduleAt(commitQueue.front().readyAt, commitTimer);
+    }
+}
+
+void AggregatedConsensusEngine::applyVerifiedCommits()
+{
+    while (!commitQueue.empty() && commitQueue.front().readyAt <= simTime()) {
+        const PendingCommit& commit = commitQueue.front();
+        if (commit.accepted)
+            host.finalizeTransaction(commit.transactionId);
+        else
+            host.rejectTransaction(commit.transactionId);
+        commitQueue.pop_front();
+    }
+    if (!commitQueue.empty()) {
+        module->scheduleAt(commitQueue.front().readyAt, commitTimer);
+    }
+}
+
+bool AggregatedConsensusEngine::handlePacket(Packet *packet, CoCoChainMessageType type)
+{
+    switch (type) {
+        case COCOCHAIN_CONSENSUS: {
+            // A vote for one of our transactions
+            const auto& consensusPacket = packet->peekAtFront<CoCoChainConsensusPacket>();
+            ConsensusMessage msg;
+            msg.type = static_cast<ConsensusMessage::Type>(consensusPacket->getConsensusType());
+            msg.transactionId = consensusPacket->getTransactionId();
+            msg.senderId = consensusPacket->getSenderId();
+            msg.senderIndex = consensusPacket->getSenderIndex();
+            msg.vote = consensusPacket->getVote();
+            msg.timestamp = consensusPacket->getTimestamp();
+
+            if (msg.type != ConsensusMessage::VOTE) return true;
+
+            VoteTally *tally = countVote(msg);
+            if (!tally) return true;
+
+            bool accepted = tally->getAcceptVotes() >= tally->getRequiredVotes();
+            sendCommit(msg.transactionId, *tally, accepted);
+            if (accepted)
+                host.finalizeTransaction(msg.transactionId);
+            else
+                host.rejectTransaction(msg.transactionId);
+            dropVoteTally(msg.transactionId);
+            return true;
+        }
+        case COCOCHAIN_COMMIT: {
+            const auto& commitPacket = packet->peekAtFront<CoCoChainCommitPacket>();
+            processCommit(*commitPacket);
+            return true;
+        }
+        default:
+            return false;
+    }
+}
+
+bool AggregatedConsensusEngine::handleTimer(cMessage *msg)
+{
+    if (msg != commitTimer) return false;
+    applyVerifiedCommits();
+    return true;
+}
+
+void AggregatedConsensusEngine::recordScalars(cComponent *component)
+{
+    component->recordScalar("COMMITs sent", totalCommitsSent);
+}
@@ -0,0 +1,206 @@
+//
+// CoCoChain Consensus Engines
+//
+
+#ifndef __COCOCHAIN_CONSENSUSENGINE_H_
+#define __COCOCHAIN_CONSENSUSENGINE_H_
+
+#include <omnetpp.h>
+#include <inet/common/packet/Packet.h>
+#include <inet/networklayer/common/L3Address.h>
+#include <cstdint>
+#include <deque>
+#include <vector>
+
+#include "CoCoChainPacket_m.h"
+#include "Transaction.h"
+#include "VoteTable.h"
+
+using namespace omnetpp;
+using namespace inet;
+
+// What a consensus engine needs from the application hosting it. Storing
+// transactions, verification, the neighbour table and confirmation
+// bookkeeping stay in the app; voting and tallying live in the engine.
+class IConsensusHost
+{
+public:
+    virtual ~IConsensusHost() {}
+
+    virtual int getHostId() const = 0; // module ID
+    virtual int getHostIndex() const = 0; // dense node index, as in Transaction::originator
+    virtual int getNumNodes() const = 0; // nodes registered so far
+    virtual int getNeighbourhoodSize() const = 0; // nodes currently able to vote
+    virtual int getRequiredVotes() const = 0; // quorum for the current neighbourhood
+    virtual int getMinRequiredVotes() const = 0; // floor of getRequiredVotes()
+    virtual int getLogSampleInterval() const = 0; // see EV_TX
+
+    // transactionTimestamp (us) is that of the transaction the packet is
+    // about, or of the newest one for a batch; the packet is worthless
+    // maxTransactionAge after it
+    virtual void sendConsensusPacket(Packet *packet, const L3Address& destAddr, uint64_t transactionTimestamp) = 0;
+
+    // Outcome of consensus; the engine forgets its own state for txId itself
+    virtual void finalizeTransaction(uint64_t txId) = 0;
+    virtual void rejectTransaction(uint64_t txId) = 0;
+};
+
+// Voting protocol run by CoCoChainApp, chosen by its consensusMode
+// parameter. Engines own their timers, which the app forwards through
+// handleTimer(). Times are in microseconds of simulation time.
+class IConsensusEngine
+{
+public:
+    virtual ~IConsensusEngine() {}
+
+    // A verified neighbour transaction was stored; cast our vote
+    virtual void startConsensus(const Transaction& tx, int requiredVotes) = 0;
+
+    // We originated txId; votes for it may come back to us
+    virtual void trackTransaction(uint64_t txId, int requiredVotes) = 0;
+
+    // Returns false if the packet is not a message type of this engine
+    virtual bool handlePacket(Packet *packet, CoCoChainMessageType type) = 0;
+    virtual bool handleTimer(cMessage *msg) = 0;
+
+    // Drops state of transactions opened before cutoff
+    virtual void expire(uint64_t cutoff) = 0;
+
+    // Presizes per-transaction tables for this many live transactions
+    virtual void reserve(size_t) {}
+
+    // Pool blocks allocated and table rehashes by the engine so far
+    virtual size_t getAllocationCount() const = 0;
+
+    virtual void recordScalars(cComponent *) {}
+};
+
+// Shared by engines that count votes per transaction: a VoteTable of
+// tallies, each with its quorum snapshot
+class TallyingConsensusEngine : public IConsensusEngine
+{
+protected:
+    IConsensusHost& host;
+    cSimpleModule *module; // schedules and owns the engine's timers
+    VoteTable consensusVotes;
+    simsignal_t timeToFirstVoteSignal;
+    simsignal_t timeToQuorumSignal;
+
+    VoteTally& openVoteTally(uint64_t txId);
+    void dropVoteTally(uint64_t txId);
+
+    // Quorum actually required when the full-neighbourhood quorum is
+    // requiredVotes; engines that sample voters scale it down
+    virtual int scaleQuorum(int requiredVotes) const { return requiredVotes; }
+
+    // Counts a vote, ignoring repeats from the same sender; returns the
+    // tally once it has reached its quorum, nullptr otherwise
+    VoteTally *countVote(const ConsensusMessage& vote);
+    ConsensusMessage makeVote(const Transaction& tx);
+
+public:
+    TallyingConsensusEngine(IConsensusHost& host, cSimpleModule *module);
+
+    virtual void startConsensus(const Transaction& tx, int requiredVotes) override;
+    virtual void trackTransaction(uint64_t txId, int requiredVotes) override;
+    virtual void expire(uint64_t cutoff) override;
+    virtual void reserve(size_t expectedLive) override { consensusVotes.reserve(expectedLive); }
+    virtual size_t getAllocationCount() const override { return consensusVotes.getAllocationCount(); }
+};
+
+// All-to-all scheme: every node broadcasts its vote and tallies all votes
+// it hears. Votes can be batched over voteBatchWindow into one packet.
+class BroadcastConsensusEngine : public TallyingConsensusEngine
+{
+private:
+    simtime_t voteBatchWindow; // 0 = no batching
+    int voteBatchSize;
+
+    // Votes waiting for the next batch; bit i of voteBatchBitmap is the
+    // vote for voteBatchIds[i]
+    std::vector<uint64_t> voteBatchIds;
+    uint64_t voteBatchBitmap;
+    uint64_t voteBatchNewest; // newest transaction timestamp in the batch (us)
+    cMessage *voteBatchTimer;
+
+    void sendVote(const ConsensusMessage& vote, uint64_t transactionTimestamp);
+    void queueVote(const ConsensusMessage& vote, uint64_t transactionTimestamp);
+    void flushVoteBatch();
+    void processVote(const ConsensusMessage& vote);
+
+protected:
+    void castVote(const Transaction& tx);
+
+public:
+    BroadcastConsensusEngine(IConsensusHost& host, cSimpleModule *module, simtime_t voteBatchWindow, int voteBatchSize);
+    virtual ~BroadcastConsensusEngine();
+
+    virtual void startConsensus(const Transaction& tx, int requiredVotes) override;
+    virtual bool handlePacket(Packet *packet, CoCoChainMessageType type) override;
+    virtual bool handleTimer(cMessage *msg) override;
+};
+
+// Sampled gossip: each node votes on a transaction only with probability
+// p, chosen so that at least one of the n neighbours votes with
+// probability coverage (1 - (1 - p)^n >= coverage). Quorums scale by p and
+// keep the broadcast engine's BFT fraction; p is raised until that quorum,
+// and the minimum quorum (fanout, or the host's minimum if larger), lie a
+// confidence margin below the expected number of voters. With
+// bftThreshold 0.67 that is about 150 expected voters, so neighbourhoods
+// below about 300 nodes vote as in broadcast; see GossipQuorum.
+class GossipConsensusEngine : public BroadcastConsensusEngine
+{
+private:
+    double coverage;
+    int fanout; // minimum quorum; 0 = the host's minimum
+    int votesCast;
+    int votesSkipped;
+
+    int getMinQuorum() const;
+    double getVoteProbability() const;
+
+protected:
+    virtual int scaleQuorum(int requiredVotes) const override;
+
+public:
+    GossipConsensusEngine(IConsensusHost& host, cSimpleModule *module, simtime_t voteBatchWindow, int voteBatchSize, double coverage, int fanout);
+
+    virtual void startConsensus(const Transaction& tx, int requiredVotes) override;
+    virtual void recordScalars(cComponent *component) override;
+};
+
+// Votes are unicast to the originator, which tallies them and broadcasts
+// one COMMIT with the voter bitset. The BLS aggregate-signature check of a
+// COMMIT is modelled as a delay, serialized per node.
+class AggregatedConsensusEngine : public TallyingConsensusEngine
+{
+private:
+    simtime_t aggregateVerifyDelay;
+    simtime_t aggregateKeyDelay;
+
+    // Received COMMITs whose modelled check is still running; readyAt is
+    // non-decreasing
+    struct PendingCommit {
+        simtime_t readyAt;
+        uint64_t transactionId;
+        bool accepted;
+    };
+    std::deque<PendingCommit> commitQueue;
+    cMessage *commitTimer;
+    int totalCommitsSent;
+
+    void sendCommit(uint64_t txId, const VoteTally& tally, bool accepted);
+    void processCommit(const CoCoChainCommitPacket& commit);
+    void applyVerifiedCommits();
+
+public:
+    AggregatedConsensusEngine(IConsensusHost& host, cSimpleModule *module, simtime_t aggregateVerifyDelay, simtime_t aggregateKeyDelay);
+    virtual ~AggregatedConsensusEngine();
+
+    virtual void startConsensus(const Transaction& tx, int requiredVotes) override;
+    virtual bool handlePacket(Packet *packet, CoCoChainMessageType type) override;
+    virtual bool handleTimer(cMessage *msg) override;
+    virtual void recordScalars(cComponent *component) override;
+};
+
+#endif
@@ -0,0 +1,174 @@
+//
+// CoCoChain Confirmed-Transaction Dedup Filters Implementation
+//
+
+#include "DedupFilter.h"
+#include "TransactionId.h"
+#include <algorithm>
+#include <cmath>
+
+//
+// ExactDedupFilter
+//
+
+bool ExactDedupFilter::insert(uint64_t txId, uint64_t now)
+{
+    auto entry = confirmedAt.tryEmplace(txId);
+    if (!entry.second) return false;
+    *entry.first = now;
+    return true;
+}
+
+bool ExactDedupFilter::contains(uint64_t txId) const
+{
+    return confirmedAt.contains(txId);
+}
+
+void ExactDedupFilter::expire(uint64_t cutoff)
+{
+    confirmedAt.eraseIf([&](uint64_t, uint64_t time) { return time < cutoff; });
+}
+
+size_t ExactDedupFilter::getMemoryUsage() const
+{
+    return confirmedAt.capacity() * (2 * sizeof(uint64_t) + 1);
+}
+
+//
+// SlidingWindowDedupFilter
+//
+
+SlidingWindowDedupFilter::SlidingWindowDedupFilter(size_t windowSize) :
+    windowSize(std::max<size_t>(64, (windowSize + 63) / 64 * 64))
+{
+}
+
+bool SlidingWindowDedupFilter::testBit(const Window& window, uint64_t sequence) const
+{
+    size_t bit = sequence % windowSize;
+    return window.bits[bit / 64] & (1ULL << (bit % 64));
+}
+
+bool SlidingWindowDedupFilter::insert(uint64_t txId, uint64_t now)
+{
+    uint64_t sequence = transactionSequence(txId);
+    Window& window = windows[transactionOriginator(txId)];
+    window.lastUpdate = now;
+
+    if (window.bits.empty()) {
+        window.bits.assign(windowSize / 64, 0);
+        window.highest = sequence;
+    }
+    else if (sequence > window.highest) {
+        // Slide forward, clearing the slots of the skipped sequence numbers
+        uint64_t advance = sequence - window.highest;
+        if (advance >= windowSize) {
+            std::fill(window.bits.begin(), window.bits.end(), 0);
+        }
+        else {
+            for (uint64_t s = window.highest + 1; s <= sequence; s++) {
+                size_t bit = s % windowSize;
+                window.bits[bit / 64] &= ~(1ULL << (bit % 64));
+            }
+        }
+        window.highest = sequence;
+    }
+    else if (window.highest - sequence >= windowSize || testBit(window, sequence)) {
+        return false;
+    }
+
+    size_t bit = sequence % windowSize;
+    window.bits[bit / 64] |= 1ULL << (bit % 64);
+    return true;
+}
+
+bool SlidingWindowDedupFilter::contains(uint64_t txId) const
+{
+    const Window *window = windows.find(transactionOriginator(txId));
+    if (!window || window->bits.empty()) return false;
+
+    uint64_t sequence = transactionSequence(txId);
+    if (sequence > window->highest) return false;
+    return window->highest - sequence >= windowSize || testBit(*window, sequence);
+}
+
+void SlidingWindowDedupFilter::expire(uint64_t cutoff)
+{
+    // Drop windows of originators that have gone silent
+    windows.eraseIf([&](uint64_t, const Window& window) { return window.lastUpdate < cutoff; });
+}
+
+size_t SlidingWindowDedupFilter::getMemoryUsage() const
+{
+    return windows.capacity() * (sizeof(uint64_t) + sizeof(Window) + 1) + windows.size() * windowSize / 8;
+}
+
+//
+// RotatingBloomFilter
+//
+
+RotatingBloomFilter::RotatingBloomFilter(size_t capacity, double falsePositiveRate) :
+    capacity(std::max<size_t>(1, capacity))
+{
+    // Two generations are checked per lookup, so split the target rate
+    double p = std::min(0.5, std::max(1e-9, falsePositiveRate / 2));
+    double optimalBits = -static_cast<double>(this->capacity) * std::log(p) / (std::log(2.0) * std::log(2.0));
+    numBits = 64;
+    while (numBits < optimalBits) numBits *= 2;
+    numHashes = std::max(1, std::min(16, static_cast<int>(std::lround(numBits / static_cast<double>(this->capacity) * std::log(2.0)))));
+
+    current.bits.assign(numBits / 64, 0);
+    previous.bits.assign(numBits / 64, 0);
+}
+
+bool RotatingBloomFilter::test(const Generation& generation, uint64_t txId) const
+{
+    uint64_t h1 = mixTransactionId(txId);
+    uint64_t h2 = mixTransactionId(txId ^ 0x9e3779b97f4a7c15ULL) | 1;
+    for (int i = 0; i < numHashes; i++) {
+        size_t bit = (h1 + i * h2) & (numBits - 1);
+        if (!(generation.bits[bit / 64] & (1ULL << (bit % 64)))) return false;
+    }
+    return true;
+}
+
+void RotatingBloomFilter::rotate()
+{
+    std::swap(current, previous);
+    std::fill(current.bits.begin(), current.bits.end(), 0);
+    current.inserted = 0;
+    current.startedAt = 0;
+}
+
+bool RotatingBloomFilter::insert(uint64_t txId, uint64_t now)
+{
+    if (contains(txId)) return false;
+    if (current.inserted >= capacity) rotate();
+    if (current.inserted == 0) current.startedAt = now;
+
+    uint64_t h1 = mixTransactionId(txId);
+    uint64_t h2 = mixTransactionId(txId ^ 0x9e3779b97f4a7c15ULL) | 1;
+    for (int i = 0; i < numHashes; i++) {
+        size_t bit = (h1 + i * h2) & (numBits - 1);
+        current.bits[bit / 64] |= 1ULL << (bit % 64);
+    }
+    current.inserted++;
+    return true;
+}
+
+bool RotatingBloomFilter::contains(uint64_t txId) const
+{
+    return test(current, txId) || test(previous, txId);
+}
+
+void RotatingBloomFilter::expire(uint64_t cutoff)
+{
+    // Everything in the previous generation predates the first insert into
+    // the current one, so once that is past the cutoff it can be recycled
+    if (current.inserted > 0 && current.startedAt < cutoff) rotate();
+}
+
+size_t RotatingBloomFilter::getMemoryUsage() const
+{
+    return 2 * numBits / 8;
+}
@@ -0,0 +1,100 @@
+//
+// CoCoChain Confirmed-Transaction Dedup Filters
+//
+
+#ifndef __COCOCHAIN_DEDUPFILTER_H_
+#define __COCOCHAIN_DEDUPFILTER_H_
+
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+
+#include "FlatHashMap.h"
+
+// Answers "has this transaction already been confirmed here?". Times are in
+// microseconds of simulation time, like Transaction::timestamp.
+class IDedupFilter
+{
+public:
+    virtual ~IDedupFilter() {}
+
+    // Records txId; returns false if it was (or may have been) seen before
+    virtual bool insert(uint64_t txId, uint64_t now) = 0;
+    virtual bool contains(uint64_t txId) const = 0;
+
+    // Forgets IDs recorded before cutoff, where the structure supports it
+    virtual void expire(uint64_t cutoff) = 0;
+
+    virtual size_t getMemoryUsage() const = 0;
+};
+
+// Exact set of confirmed IDs with their confirmation times, aged out by expire()
+class ExactDedupFilter : public IDedupFilter
+{
+private:
+    FlatHashMap<uint64_t> confirmedAt;
+
+public:
+    virtual bool insert(uint64_t txId, uint64_t now) override;
+    virtual bool contains(uint64_t txId) const override;
+    virtual void expire(uint64_t cutoff) override;
+    virtual size_t getMemoryUsage() const override;
+};
+
+// Per-originator anti-replay window over the monotone sequence numbers.
+// Sequences older than the window are reported as seen.
+class SlidingWindowDedupFilter : public IDedupFilter
+{
+private:
+    struct Window {
+        uint64_t highest = 0;
+        uint64_t lastUpdate = 0;
+        std::vector<uint64_t> bits; // bit (seq % windowSize) set if seq seen
+    };
+
+    size_t windowSize; // multiple of 64
+    FlatHashMap<Window> windows; // keyed by originator
+
+    bool testBit(const Window& window, uint64_t sequence) const;
+
+public:
+    explicit SlidingWindowDedupFilter(size_t windowSize);
+
+    virtual bool insert(uint64_t txId, uint64_t now) override;
+    virtual bool contains(uint64_t txId) const override;
+    virtual void expire(uint64_t cutoff) override;
+    virtual size_t getMemoryUsage() const override;
+};
+
+// Two-generation Bloom filter: inserts go to the current generation, lookups
+// check both, and the generations rotate when the current one is full or
+// its first entry is older than the expiry cutoff. Memory is fixed by capacity and the target
+// false-positive rate; a false positive suppresses one confirmation.
+class RotatingBloomFilter : public IDedupFilter
+{
+private:
+    struct Generation {
+        std::vector<uint64_t> bits;
+        size_t inserted = 0;
+        uint64_t startedAt = 0; // time of the first insert
+    };
+
+    size_t capacity;
+    size_t numBits; // power of two
+    int numHashes;
+    Generation current;
+    Generation previous;
+
+    bool test(const Generation& generation, uint64_t txId) const;
+    void rotate();
+
+public:
+    RotatingBloomFilter(size_t capacity, double falsePositiveRate);
+
+    virtual bool insert(uint64_t txId, uint64_t now) override;
+    virtual bool contains(uint64_t txId) const override;
+    virtual void expire(uint64_t cutoff) override;
+    virtual size_t getMemoryUsage() const override;
+};
+
+#endif
@@ -0,0 +1,198 @@
+//
+// CoCoChain Flat Hash Map
+//
+
+#ifndef __COCOCHAIN_FLATHASHMAP_H_
+#define __COCOCHAIN_FLATHASHMAP_H_
+
+#include <cstdint>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+// splitmix64 finalizer; spreads structured IDs over all 64 bits
+inline uint64_t mixTransactionId(uint64_t key)
+{
+    key ^= key >> 30;
+    key *= 0xbf58476d1ce4e5b9ULL;
+    key ^= key >> 27;
+    key *= 0x94d049bb133111ebULL;
+    key ^= key >> 31;
+    return key;
+}
+
+// Open-addressing hash map keyed on 64-bit transaction IDs. Entries live in
+// one contiguous array (linear probing, backward-shift deletion, load factor
+// <= 3/4), so lookups touch one or two cache lines instead of chasing
+// red-black tree nodes. Keys are mixed before probing because tx IDs are
+// highly structured (node index << 32 | counter).
+template <typename V>
+class FlatHashMap
+{
+private:
+    struct Entry {
+        uint64_t key;
+        V value;
+    };
+
+    std::vector<Entry> entries;
+    std::vector<uint8_t> used;
+    size_t count;
+    size_t mask;
+    size_t rehashes;
+
+    size_t slotOf(uint64_t key) const { return mixTransactionId(key) & mask; }
+
+    size_t findSlot(uint64_t key) const {
+        if (count == 0) return npos;
+        for (size_t i = slotOf(key); used[i]; i = (i + 1) & mask) {
+            if (entries[i].key == key) return i;
+        }
+        return npos;
+    }
+
+    void rehash(size_t newCapacity) {
+        std::vector<Entry> oldEntries;
+        std::vector<uint8_t> oldUsed;
+        oldEntries.swap(entries);
+        oldUsed.swap(used);
+        entries.assign(newCapacity, Entry());
+        used.assign(newCapacity, 0);
+        mask = newCapacity - 1;
+        rehashes++;
+        for (size_t i = 0; i < oldEntries.size(); i++) {
+            if (!oldUsed[i]) continue;
+            size_t j = slotOf(oldEntries[i].key);
+            while (used[j]) j = (j + 1) & mask;
+            entries[j].key = oldEntries[i].key;
+            entries[j].value = std::move(oldEntries[i].value);
+            used[j] = 1;
+        }
+    }
+
+    static size_t capacityFor(size_t n) {
+        size_t capacity = 16;
+        while (capacity * 3 / 4 < n) capacity *= 2;
+        return capacity;
+    }
+
+    // Removes the entry at slot i and shifts the following cluster back so
+    // that probing never needs tombstones
+    void eraseSlot(size_t i) {
+        size_t j = i;
+        for (;;) {
+            j = (j + 1) & mask;
+            if (!used[j]) break;
+            size_t home = slotOf(entries[j].key);
+            // Move j into the hole unless its home lies cyclically in (i, j]
+            bool inRange = (i <= j) ? (i < home && home <= j) : (i < home || home <= j);
+            if (inRange) continue;
+            entries[i].key = entries[j].key;
+            entries[i].value = std::move(entries[j].value);
+            i = j;
+        }
+        used[i] = 0;
+        entries[i].value = V();
+        count--;
+    }
+
+public:
+    static constexpr size_t npos = static_cast<size_t>(-1);
+
+    FlatHashMap() : count(0), mask(0), rehashes(0) {}
+
+    // Presizes the table so that n entries fit without rehashing
+    void reserve(size_t n) {
+        size_t capacity = capacityFor(n);
+        if (capacity > entries.size()) rehash(capacity);
+    }
+
+    // Returns the value for key and whether it was newly inserted
+    std::pair<V*, bool> tryEmplace(uint64_t key) {
+        if ((count + 1) > entries.size() * 3 / 4) rehash(capacityFor(count + 1));
+        size_t i = slotOf(key);
+        for (; used[i]; i = (i + 1) & mask) {
+            if (entries[i].key == key) return {&entries[i].value, false};
+        }
+        used[i] = 1;
+        entries[i].key = key;
+        count++;
+        return {&entries[i].value, true};
+    }
+
+    V& operator[](uint64_t key) { return *tryEmplace(key).first; }
+
+    V *find(uint64_t key) {
+        size_t i = findSlot(key);
+        return i == npos ? nullptr : &entries[i].value;
+    }
+
+    const V *find(uint64_t key) const {
+        size_t i = findSlot(key);
+        return i == npos ? nullptr : &entries[i].value;
+    }
+
+    bool contains(uint64_t key) const { return findSlot(key) != npos; }
+
+    bool erase(uint64_t key) {
+        size_t i = findSlot(key);
+        if (i == npos) return false;
+        eraseSlot(i);
+        return true;
+    }
+
+    // Erases all entries for which pred(key, value) is true. A slot that
+    // receives a shifted entry is re-examined, so nothing is skipped.
+    template <typename P>
+    size_t eraseIf(P pred) {
+        size_t erased = 0;
+        for (size_t i = 0; i < entries.size();) {
+            if (used[i] && pred(entries[i].key, entries[i].value)) {
+                eraseSlot(i);
+                erased++;
+            }
+            else {
+                i++;
+            }
+        }
+        return erased;
+    }
+
+    template <typename F>
+    void forEach(F f) const {
+        for (size_t i = 0; i < entries.size(); i++) {
+            if (used[i]) f(entries[i].key, entries[i].value);
+        }
+    }
+
+    void clear() {
+        std::vector<Entry>().swap(entries);
+        std::vector<uint8_t>().swap(used);
+        count = 0;
+        mask = 0;
+    }
+
+    size_t size() const { return count; }
+    bool empty() const { return count == 0; }
+    size_t capacity() const { return entries.size(); }
+    // Number of table (re)allocations so far
+    size_t getRehashCount() const { return rehashes; }
+};
+
+// Set of 64-bit transaction IDs on top of FlatHashMap
+class FlatHashSet
+{
+private:
+    FlatHashMap<uint8_t> map;
+
+public:
+    void reserve(size_t n) { map.reserve(n); }
+    bool insert(uint64_t key) { return map.tryEmplace(key).second; }
+    bool contains(uint64_t key) const { return map.contains(key); }
+    bool erase(uint64_t key) { return map.erase(key); }
+    void clear() { map.clear(); }
+    size_t size() const { return map.size(); }
+    bool empty() const { return map.empty(); }
+};
+
+#endif
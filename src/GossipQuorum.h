@@ -0,0 +1,55 @@
+//
+// CoCoChain Gossip Quorum
+//
+
+#ifndef __COCOCHAIN_GOSSIPQUORUM_H_
+#define __COCOCHAIN_GOSSIPQUORUM_H_
+
+#include <algorithm>
+#include <cmath>
+
+// Vote probability and quorum of sampled gossip voting, independent of the
+// simulator. With n neighbours each voting with probability p, the number
+// of votes is binomial with mean np and deviation sigma = sqrt(np(1-p)).
+// The quorum keeps the BFT fraction of the broadcast engine, bftQuorum / n,
+// applied to the sampled voters (and never drops below minQuorum). Instead
+// of loosening it, p is raised until the quorum lies CONFIDENCE_SIGMAS
+// below the expected votes, so an honest transaction reaches it rather than
+// randomly timing out. Near-BFT fractions therefore need dozens of
+// expected voters, and gossip only saves traffic in large neighbourhoods.
+namespace GossipQuorum {
+
+constexpr double CONFIDENCE_SIGMAS = 4.0;
+
+// Smallest mean m with m - CONFIDENCE_SIGMAS * sqrt(m) >= fraction * m + offset
+inline double minExpectedVoters(double fraction, double offset)
+{
+    double slack = std::max(1.0 - fraction, 1e-3);
+    double root = (CONFIDENCE_SIGMAS + std::sqrt(CONFIDENCE_SIGMAS * CONFIDENCE_SIGMAS + 4.0 * slack * offset)) / (2.0 * slack);
+    return root * root;
+}
+
+// At least one of n neighbours votes with probability coverage, and
+// enough are expected to vote for the quorum to be reached
+inline double voteProbability(int n, double coverage, int bftQuorum, int minQuorum)
+{
+    if (n <= 1) return 1.0;
+    double fraction = std::min(1.0, bftQuorum / static_cast<double>(n));
+    double p = 1.0 - std::pow(1.0 - coverage, 1.0 / n);
+    // The scaled quorum rounds up by at most one vote
+    p = std::max(p, minExpectedVoters(fraction, 1.0) / n);
+    p = std::max(p, minExpectedVoters(0.0, minQuorum) / n);
+    // Sampling most of a neighbourhood saves little traffic; everyone
+    // votes instead
+    return p > 0.5 ? 1.0 : p;
+}
+
+// Quorum among the sampled voters: bftQuorum of the n neighbours scaled by p
+inline int quorum(double p, int bftQuorum, int minQuorum)
+{
+    return std::max(std::max(1, minQuorum), static_cast<int>(std::ceil(bftQuorum * p)));
+}
+
+} // namespace GossipQuorum
+
+#endif
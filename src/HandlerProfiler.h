@@ -0,0 +1,70 @@
+//
+// CoCoChain Handler Profiler
+//
+
+#ifndef __COCOCHAIN_HANDLERPROFILER_H_
+#define __COCOCHAIN_HANDLERPROFILER_H_
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Wall-clock time and call count of one handler. Times are inclusive:
+// a handler called from another one is counted in both.
+struct HandlerProfile {
+    std::string name;
+    uint64_t calls = 0;
+    uint64_t nanoseconds = 0;
+};
+
+// Per-module set of handler profiles. When disabled, get() returns
+// nullptr and the timers below cost one branch each.
+class HandlerProfiler
+{
+private:
+    std::vector<HandlerProfile> profiles;
+    bool enabled;
+
+public:
+    HandlerProfiler() : enabled(false) {}
+
+    void setEnabled(bool value) { enabled = value; }
+    bool isEnabled() const { return enabled; }
+
+    // Returns the handle to pass to get()
+    int add(const char *name) {
+        HandlerProfile profile;
+        profile.name = name;
+        profiles.push_back(profile);
+        return static_cast<int>(profiles.size()) - 1;
+    }
+
+    HandlerProfile *get(int handle) { return enabled ? &profiles[handle] : nullptr; }
+    const std::vector<HandlerProfile>& getProfiles() const { return profiles; }
+};
+
+// Adds the lifetime of the enclosing scope to a profile (if any)
+class ScopedHandlerTimer
+{
+private:
+    typedef std::chrono::steady_clock Clock;
+    HandlerProfile *profile;
+    Clock::time_point start;
+
+public:
+    explicit ScopedHandlerTimer(HandlerProfile *profile) : profile(profile) {
+        if (profile) start = Clock::now();
+    }
+
+    ~ScopedHandlerTimer() {
+        if (!profile) return;
+        profile->calls++;
+        profile->nanoseconds += std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count();
+    }
+
+    ScopedHandlerTimer(const ScopedHandlerTimer&) = delete;
+    ScopedHandlerTimer& operator=(const ScopedHandlerTimer&) = delete;
+};
+
+#endif
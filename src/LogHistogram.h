@@ -0,0 +1,130 @@
+//
+// CoCoChain Log-Bucketed Histogram
+//
+
+#ifndef __COCOCHAIN_LOGHISTOGRAM_H_
+#define __COCOCHAIN_LOGHISTOGRAM_H_
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+// HDR-style histogram of non-negative values: every power of two is split
+// into SUB_BUCKETS equal buckets, so a bucket is at most 1/SUB_BUCKETS
+// (about 3%) of its lower bound wide at any magnitude. Count, sum, min and
+// max are exact. The bucket grid is the same for every instance, so
+// histograms from different modules or runs merge by adding counts. Only
+// the range between the lowest and highest used bucket is stored.
+class LogHistogram
+{
+public:
+    static constexpr int SUB_BUCKET_BITS = 5;
+    static constexpr int SUB_BUCKETS = 1 << SUB_BUCKET_BITS;
+    static constexpr int MIN_EXPONENT = -40; // ~1e-12; smaller values go to the zero bucket
+
+private:
+    std::vector<uint64_t> buckets; // buckets[i] counts bucket firstBucket + i
+    int firstBucket;
+    uint64_t zeroCount; // values below 2^(MIN_EXPONENT - 1), including 0
+    uint64_t count;
+    double sum;
+    double min;
+    double max;
+
+    // Grows the stored range to include bucket b
+    uint64_t& bucketAt(int b) {
+        if (buckets.empty()) {
+            firstBucket = b;
+            buckets.assign(1, 0);
+        }
+        else if (b < firstBucket) {
+            buckets.insert(buckets.begin(), firstBucket - b, 0);
+            firstBucket = b;
+        }
+        else if (b >= firstBucket + static_cast<int>(buckets.size())) {
+            buckets.resize(b - firstBucket + 1, 0);
+        }
+        return buckets[b - firstBucket];
+    }
+
+public:
+    LogHistogram() : firstBucket(0), zeroCount(0), count(0), sum(0),
+        min(std::numeric_limits<double>::infinity()), max(-std::numeric_limits<double>::infinity()) {}
+
+    // Bucket index of value, or -1 for the zero bucket
+    static int bucketOf(double value) {
+        int exponent;
+        double mantissa = std::frexp(value, &exponent); // value = mantissa * 2^exponent, mantissa in [0.5, 1)
+        if (!(value > 0) || exponent < MIN_EXPONENT) return -1;
+        int sub = std::min(SUB_BUCKETS - 1, static_cast<int>((mantissa - 0.5) * 2 * SUB_BUCKETS));
+        return (exponent - MIN_EXPONENT) * SUB_BUCKETS + sub;
+    }
+
+    static double bucketLowerBound(int b) {
+        return std::ldexp(0.5 + (b % SUB_BUCKETS) * (0.5 / SUB_BUCKETS), b / SUB_BUCKETS + MIN_EXPONENT);
+    }
+    static double bucketUpperBound(int b) { return bucketLowerBound(b + 1); }
+
+    void add(double value, uint64_t n = 1) {
+        if (n == 0) return;
+        int b = bucketOf(value);
+        if (b < 0) zeroCount += n; else bucketAt(b) += n;
+        count += n;
+        sum += value * n;
+        min = std::min(min, value);
+        max = std::max(max, value);
+    }
+
+    void merge(const LogHistogram& other) {
+        if (other.count == 0) return;
+        for (size_t i = 0; i < other.buckets.size(); i++) {
+            if (other.buckets[i]) bucketAt(other.firstBucket + static_cast<int>(i)) += other.buckets[i];
+        }
+        zeroCount += other.zeroCount;
+        count += other.count;
+        sum += other.sum;
+        min = std::min(min, other.min);
+        max = std::max(max, other.max);
+    }
+
+    // Value below which a fraction q of the samples lie: the midpoint of
+    // the bucket holding that rank, clamped to [min, max]
+    double quantile(double q) const {
+        if (count == 0) return std::numeric_limits<double>::quiet_NaN();
+        uint64_t rank = static_cast<uint64_t>(std::ceil(std::max(0.0, std::min(1.0, q)) * count));
+        uint64_t seen = zeroCount;
+        if (rank <= seen) return min;
+        for (size_t i = 0; i < buckets.size(); i++) {
+            seen += buckets[i];
+            if (rank <= seen) {
+                int b = firstBucket + static_cast<int>(i);
+                double mid = 0.5 * (bucketLowerBound(b) + bucketUpperBound(b));
+                return std::max(min, std::min(max, mid));
+            }
+        }
+        return max;
+    }
+
+    // Calls f(lower, upper, count) for every non-empty bucket, the zero
+    // bucket first as [0, smallest bucket bound)
+    template <typename F>
+    void forEachBucket(F f) const {
+        if (zeroCount) f(0.0, bucketLowerBound(0), zeroCount);
+        for (size_t i = 0; i < buckets.size(); i++) {
+            int b = firstBucket + static_cast<int>(i);
+            if (buckets[i]) f(bucketLowerBound(b), bucketUpperBound(b), buckets[i]);
+        }
+    }
+
+    uint64_t getCount() const { return count; }
+    double getSum() const { return sum; }
+    double getMean() const { return count ? sum / count : std::numeric_limits<double>::quiet_NaN(); }
+    double getMin() const { return count ? min : std::numeric_limits<double>::quiet_NaN(); }
+    double getMax() const { return count ? max : std::numeric_limits<double>::quiet_NaN(); }
+    // Heap memory held by the buckets
+    size_t getMemoryUsage() const { return buckets.capacity() * sizeof(uint64_t); }
+};
+
+#endif
@@ -0,0 +1,55 @@
+//
+// CoCoChain Log-Histogram Result Recorder Implementation
+//
+
+#include "LogHistogramRecorder.h"
+#include <string>
+#include <vector>
+
+Register_ResultRecorder("loghistogram", LogHistogramRecorder);
+
+void LogHistogramRecorder::collect(simtime_t_cref, double value, cObject *)
+{
+    histogram.add(value);
+}
+
+void LogHistogramRecorder::finish(cResultFilter *)
+{
+    opp_string_map attributes = getStatisticAttributes();
+    recordLogHistogram(getComponent(), getStatisticName(), histogram, &attributes);
+}
+
+void recordLogHistogram(cComponent *component, const std::string& name, const LogHistogram& histogram, opp_string_map *attributes)
+{
+    auto record = [&](const char *suffix, double value) {
+        getEnvir()->recordScalar(component, (name + suffix).c_str(), value, attributes);
+    };
+
+    record(":count", histogram.getCount());
+    if (histogram.getCount() == 0) return;
+    record(":sum", histogram.getSum());
+    record(":mean", histogram.getMean());
+    record(":min", histogram.getMin());
+    record(":max", histogram.getMax());
+    record(":p50", histogram.quantile(0.5));
+    record(":p90", histogram.quantile(0.9));
+    record(":p99", histogram.quantile(0.99));
+    record(":p999", histogram.quantile(0.999));
+
+    // One bin per used bucket, each weighted by its count at its midpoint.
+    // A gap between used buckets becomes one empty bin; every edge is on
+    // the grid, so merged histograms stay exact.
+    std::vector<double> edges;
+    std::vector<std::pair<double, uint64_t>> samples;
+    histogram.forEachBucket([&](double lower, double upper, uint64_t count) {
+        if (edges.empty() || edges.back() != lower) edges.push_back(lower);
+        edges.push_back(upper);
+        samples.push_back({0.5 * (lower + upper), count});
+    });
+    std::string binsName = name + ":loghistogram";
+    cHistogram bins(binsName.c_str(), true);
+    bins.setBinEdges(edges);
+    for (const auto& sample : samples)
+        bins.collectWeighted(sample.first, sample.second);
+    getEnvir()->recordStatistic(component, binsName.c_str(), &bins, attributes);
+}
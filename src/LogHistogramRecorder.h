@@ -0,0 +1,37 @@
+//
+// CoCoChain Log-Histogram Result Recorder
+//
+
+#ifndef __COCOCHAIN_LOGHISTOGRAMRECORDER_H_
+#define __COCOCHAIN_LOGHISTOGRAMRECORDER_H_
+
+#include <omnetpp.h>
+#include <string>
+
+#include "LogHistogram.h"
+
+using namespace omnetpp;
+
+// Writes histogram for component as the scalars name:count, :sum, :mean,
+// :min, :max, :p50, :p90, :p99 and :p999, and its buckets as the histogram
+// name:loghistogram
+void recordLogHistogram(cComponent *component, const std::string& name, const LogHistogram& histogram, opp_string_map *attributes = nullptr);
+
+// Result recorder "loghistogram": collects values into a LogHistogram in
+// memory, with no per-value output, and writes it with recordLogHistogram()
+// in finish(). The exact count, sum, mean, min and max and the quantiles
+// become scalars; the histogram bins lie on the shared LogHistogram grid,
+// so bins of any two modules or runs can be added.
+class LogHistogramRecorder : public cNumericResultRecorder
+{
+protected:
+    LogHistogram histogram;
+
+    virtual void collect(simtime_t_cref t, double value, cObject *details) override;
+    virtual void finish(cResultFilter *prev) override;
+
+public:
+    const LogHistogram& getHistogram() const { return histogram; }
+};
+
+#endif
@@ -0,0 +1,63 @@
+//
+// CoCoChain Object Pool
+//
+
+#ifndef __COCOCHAIN_OBJECTPOOL_H_
+#define __COCOCHAIN_OBJECTPOOL_H_
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+// Per-module free list of T, allocated in blocks. Released objects keep
+// their internal buffers (e.g. a heap-backed concept vector or a voter
+// bitset), so once the pool has warmed up acquire() and release() never
+// touch the heap. Callers must reinitialize acquired objects.
+template <typename T>
+class ObjectPool
+{
+private:
+    std::vector<std::unique_ptr<T[]>> blocks;
+    std::vector<T*> freeList;
+    size_t blockSize;
+    size_t inUse;
+    size_t allocations;
+
+    void grow() {
+        blocks.emplace_back(new T[blockSize]);
+        allocations++;
+        size_t total = blocks.size() * blockSize;
+        if (freeList.capacity() < total) {
+            freeList.reserve(total);
+            allocations++;
+        }
+        T *block = blocks.back().get();
+        for (size_t i = blockSize; i > 0; i--) freeList.push_back(&block[i - 1]);
+    }
+
+public:
+    explicit ObjectPool(size_t blockSize = 64) : blockSize(blockSize), inUse(0), allocations(0) {}
+
+    ObjectPool(const ObjectPool&) = delete;
+    ObjectPool& operator=(const ObjectPool&) = delete;
+
+    T *acquire() {
+        if (freeList.empty()) grow();
+        T *object = freeList.back();
+        freeList.pop_back();
+        inUse++;
+        return object;
+    }
+
+    void release(T *object) {
+        freeList.push_back(object);
+        inUse--;
+    }
+
+    size_t getInUse() const { return inUse; }
+    size_t getCapacity() const { return blocks.size() * blockSize; }
+    // Blocks and free-list growths allocated by the pool so far
+    size_t getAllocationCount() const { return allocations; }
+};
+
+#endif
@@ -0,0 +1,168 @@
+//
+// CoCoChain Semantic Digest Implementation
+//
+
+#include "SemanticDigest.h"
+#include <cmath>
+#include <cstring>
+
+namespace {
+
+const double QUANTUM = 1e6;
+
+// std::llround(value * QUANTUM) without the library call, which would
+// otherwise dominate the digest: truncate, then round the fraction half
+// away from zero. Bit-identical to llround; the fraction is exact below
+// 2^63, larger magnitudes and NaN take the library path.
+inline uint64_t quantize(double value)
+{
+    double scaled = value * QUANTUM;
+    if (!(std::fabs(scaled) < 9.0e18)) return static_cast<uint64_t>(std::llround(scaled));
+    int64_t whole = static_cast<int64_t>(scaled);
+    double fraction = scaled - static_cast<double>(whole);
+    if (fraction >= 0.5) whole++;
+    else if (fraction <= -0.5) whole--;
+    return static_cast<uint64_t>(whole);
+}
+
+// 64x64 -> 128 bit multiply, folded back to 64 bits
+inline uint64_t mum(uint64_t a, uint64_t b)
+{
+    unsigned __int128 r = static_cast<unsigned __int128>(a) * b;
+    return static_cast<uint64_t>(r) ^ static_cast<uint64_t>(r >> 64);
+}
+
+const uint64_t SECRET0 = 0xa0761d6478bd642fULL;
+const uint64_t SECRET1 = 0xe7037ed1a0b428dbULL;
+const uint64_t SECRET2 = 0x8ebc6af09c88c6e3ULL;
+
+//
+// SHA-256 (FIPS 180-4)
+//
+
+const uint32_t K[64] = {
+    0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+    0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+    0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+    0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+    0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+    0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+    0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+    0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
+};
+
+inline uint32_t rotr(uint32_t x, int n) { return (x >> n) | (x << (32 - n)); }
+
+void sha256Block(uint32_t state[8], const uint8_t block[64])
+{
+    uint32_t w[64];
+    for (int i = 0; i < 16; i++) {
+        w[i] = (uint32_t(block[4 * i]) << 24) | (uint32_t(block[4 * i + 1]) << 16) |
+               (uint32_t(block[4 * i + 2]) << 8) | uint32_t(block[4 * i + 3]);
+    }
+    for (int i = 16; i < 64; i++) {
+        uint32_t s0 = rotr(w[i - 15], 7) ^ rotr(w[i - 15], 18) ^ (w[i - 15] >> 3);
+        uint32_t s1 = rotr(w[i - 2], 17) ^ rotr(w[i - 2], 19) ^ (w[i - 2] >> 10);
+        w[i] = w[i - 16] + s0 + w[i - 7] + s1;
+    }
+
+    uint32_t a = state[0], b = state[1], c = state[2], d = state[3];
+    uint32_t e = state[4], f = state[5], g = state[6], h = state[7];
+    for (int i = 0; i < 64; i++) {
+        uint32_t t1 = h + (rotr(e, 6) ^ rotr(e, 11) ^ rotr(e, 25)) + ((e & f) ^ (~e & g)) + K[i] + w[i];
+        uint32_t t2 = (rotr(a, 2) ^ rotr(a, 13) ^ rotr(a, 22)) + ((a & b) ^ (a & c) ^ (b & c));
+        h = g; g = f; f = e; e = d + t1;
+        d = c; c = b; b = a; a = t1 + t2;
+    }
+    state[0] += a; state[1] += b; state[2] += c; state[3] += d;
+    state[4] += e; state[5] += f; state[6] += g; state[7] += h;
+}
+
+template <typename T>
+SemanticDigest fastDigest(const T *data, size_t size)
+{
+    uint64_t h = SECRET0 ^ (size * SECRET1);
+    for (size_t i = 0; i < size; i++) {
+        h = mum(quantize(data[i]) ^ SECRET1, h ^ SECRET2);
+    }
+    return mum(h ^ SECRET2, size ^ SECRET1);
+}
+
+template <typename T>
+void fastDigests(const T *const data[DIGEST_LANES], size_t size, SemanticDigest digests[DIGEST_LANES])
+{
+    uint64_t h[DIGEST_LANES];
+    for (int l = 0; l < DIGEST_LANES; l++) h[l] = SECRET0 ^ (size * SECRET1);
+    for (size_t i = 0; i < size; i++) {
+        for (int l = 0; l < DIGEST_LANES; l++)
+            h[l] = mum(quantize(data[l][i]) ^ SECRET1, h[l] ^ SECRET2);
+    }
+    for (int l = 0; l < DIGEST_LANES; l++) digests[l] = mum(h[l] ^ SECRET2, size ^ SECRET1);
+}
+
+template <typename T>
+SemanticDigest sha256Digest(const T *data, size_t size)
+{
+    uint32_t state[8] = {
+        0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a, 0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19
+    };
+
+    // Message is the quantized values as little-endian 64-bit integers
+    uint8_t block[64];
+    size_t used = 0;
+    for (size_t i = 0; i < size; i++) {
+        uint64_t q = quantize(data[i]);
+        for (int b = 0; b < 8; b++) block[used++] = static_cast<uint8_t>(q >> (8 * b));
+        if (used == 64) {
+            sha256Block(state, block);
+            used = 0;
+        }
+    }
+
+    // Padding: 0x80, zeros, 64-bit big-endian bit length
+    uint64_t bitLength = static_cast<uint64_t>(size) * 64;
+    block[used++] = 0x80;
+    if (used > 56) {
+        std::memset(block + used, 0, 64 - used);
+        sha256Block(state, block);
+        used = 0;
+    }
+    std::memset(block + used, 0, 56 - used);
+    for (int b = 0; b < 8; b++) block[56 + b] = static_cast<uint8_t>(bitLength >> (56 - 8 * b));
+    sha256Block(state, block);
+
+    // Truncate to the first 64 bits of the hash
+    return (static_cast<uint64_t>(state[0]) << 32) | state[1];
+}
+
+} // namespace
+
+SemanticDigest computeFastDigest(const double *data, size_t size)
+{
+    return fastDigest(data, size);
+}
+
+SemanticDigest computeFastDigest(const float *data, size_t size)
+{
+    return fastDigest(data, size);
+}
+
+void computeFastDigests(const double *const data[DIGEST_LANES], size_t size, SemanticDigest digests[DIGEST_LANES])
+{
+    fastDigests(data, size, digests);
+}
+
+void computeFastDigests(const float *const data[DIGEST_LANES], size_t size, SemanticDigest digests[DIGEST_LANES])
+{
+    fastDigests(data, size, digests);
+}
+
+SemanticDigest computeSha256Digest(const double *data, size_t size)
+{
+    return sha256Digest(data, size);
+}
+
+SemanticDigest computeSha256Digest(const float *data, size_t size)
+{
+    return sha256Digest(data, size);
+}
@@ -0,0 +1,39 @@
+//
+// CoCoChain Semantic Digest
+//
+
+#ifndef __COCOCHAIN_SEMANTICDIGEST_H_
+#define __COCOCHAIN_SEMANTICDIGEST_H_
+
+#include <cstdint>
+#include <cstddef>
+
+// Fixed-width digest of a concept vector. Values are quantized to 1e-6
+// (the precision the text digest used to print) and hashed as 64-bit
+// integers, so no string formatting is involved.
+typedef uint64_t SemanticDigest;
+
+enum class DigestAlgorithm {
+    FAST,   // wyhash-style 64-bit multiply-mix, a few cycles per dimension
+    SHA256  // SHA-256 truncated to 64 bits, for a realistic cryptographic cost
+};
+
+SemanticDigest computeFastDigest(const double *data, size_t size);
+SemanticDigest computeFastDigest(const float *data, size_t size);
+SemanticDigest computeSha256Digest(const double *data, size_t size);
+SemanticDigest computeSha256Digest(const float *data, size_t size);
+
+// computeFastDigest() of DIGEST_LANES vectors of the same size at once,
+// one lane per vector. The lanes' multiply chains are independent, so
+// their latencies overlap instead of adding up.
+const int DIGEST_LANES = 4;
+void computeFastDigests(const double *const data[DIGEST_LANES], size_t size, SemanticDigest digests[DIGEST_LANES]);
+void computeFastDigests(const float *const data[DIGEST_LANES], size_t size, SemanticDigest digests[DIGEST_LANES]);
+
+template <typename T>
+inline SemanticDigest computeDigest(DigestAlgorithm algorithm, const T *data, size_t size)
+{
+    return algorithm == DigestAlgorithm::SHA256 ? computeSha256Digest(data, size) : computeFastDigest(data, size);
+}
+
+#endif
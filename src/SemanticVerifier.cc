@@ -0,0 +1,67 @@
+//
+// CoCoChain Semantic Verifier Implementation
+//
+
+#include "SemanticVerifier.h"
+
+bool SemanticVerifier::verify(const ConceptStorage& data, SemanticDigest expectedDigest) const
+{
+    if (!enabled) return true;
+
+    // Recompute semantic digest and compare
+    if (digest(data) != expectedDigest) return false;
+    return checkStatistics(data);
+}
+
+bool SemanticVerifier::checkStatistics(const ConceptStorage& data) const
+{
+    return passesThresholds(computeVectorStats(data.data(), data.size()));
+}
+
+bool SemanticVerifier::passesThresholds(const VectorStats& stats) const
+{
+    // Flag as malformed if variance is too high (indicating corruption)
+    if (stats.variance > varianceThreshold) return false;
+    // Optionally flag injected extreme values
+    if (maxAbsThreshold > 0 && stats.maxAbs > maxAbsThreshold) return false;
+    return true;
+}
+
+void SemanticVerifier::verifyBatch(const ConceptBatch& batch, std::vector<uint8_t>& verdicts) const
+{
+    size_t n = batch.size();
+    verdicts.assign(n, 1);
+    if (!enabled) return;
+
+    // Digests: handed in, computed in lanes of equal-sized vectors, or one
+    // at a time for SHA-256 and for what does not fill a lane group
+    size_t lane[DIGEST_LANES];
+    int lanes = 0;
+    for (size_t i = 0; i < n; i++) {
+        if (batch.hasComputedDigest[i]) {
+            verdicts[i] = batch.computedDigests[i] == batch.digests[i];
+        }
+        else if (digestAlgorithm == DigestAlgorithm::FAST && (lanes == 0 || batch.sizes[i] == batch.sizes[lane[0]])) {
+            lane[lanes++] = i;
+            if (lanes == DIGEST_LANES) {
+                const ConceptScalar *data[DIGEST_LANES];
+                SemanticDigest computed[DIGEST_LANES];
+                for (int l = 0; l < DIGEST_LANES; l++) data[l] = batch.data(lane[l]);
+                computeFastDigests(data, batch.sizes[lane[0]], computed);
+                for (int l = 0; l < DIGEST_LANES; l++) verdicts[lane[l]] = computed[l] == batch.digests[lane[l]];
+                lanes = 0;
+            }
+        }
+        else {
+            verdicts[i] = computeDigest(digestAlgorithm, batch.data(i), batch.sizes[i]) == batch.digests[i];
+        }
+    }
+    for (int l = 0; l < lanes; l++) {
+        size_t i = lane[l];
+        verdicts[i] = computeDigest(digestAlgorithm, batch.data(i), batch.sizes[i]) == batch.digests[i];
+    }
+
+    for (size_t i = 0; i < n; i++) {
+        if (verdicts[i]) verdicts[i] = passesThresholds(computeVectorStats(batch.data(i), batch.sizes[i]));
+    }
+}
@@ -0,0 +1,90 @@
+//
+// CoCoChain Semantic Verifier
+//
+
+#ifndef __COCOCHAIN_SEMANTICVERIFIER_H_
+#define __COCOCHAIN_SEMANTICVERIFIER_H_
+
+#include <cstdint>
+#include <vector>
+
+#include "ConceptStorage.h"
+#include "SemanticDigest.h"
+#include "VectorStats.h"
+
+// Concept vectors of several transactions in structure-of-arrays form:
+// per-vector data pointers, sizes and claimed digests in parallel arrays.
+// The vectors are referenced, not copied, and must stay in place until the
+// batch is verified. A digest of the payload computed earlier (e.g. as
+// the verification cache fingerprint) can be handed in so that it is not
+// computed again. clear() keeps the capacity.
+struct ConceptBatch {
+    std::vector<const ConceptScalar*> values;
+    std::vector<uint32_t> sizes;
+    std::vector<SemanticDigest> digests;
+    std::vector<SemanticDigest> computedDigests; // valid where hasComputedDigest
+    std::vector<uint8_t> hasComputedDigest;
+
+    void add(const ConceptStorage& data, SemanticDigest digest) {
+        values.push_back(data.data());
+        sizes.push_back(data.size());
+        digests.push_back(digest);
+        computedDigests.push_back(0);
+        hasComputedDigest.push_back(0);
+    }
+    // computedDigest = the verifier's digest of data
+    void add(const ConceptStorage& data, SemanticDigest digest, SemanticDigest computedDigest) {
+        add(data, digest);
+        computedDigests.back() = computedDigest;
+        hasComputedDigest.back() = 1;
+    }
+    void clear() {
+        values.clear();
+        sizes.clear();
+        digests.clear();
+        computedDigests.clear();
+        hasComputedDigest.clear();
+    }
+    size_t size() const { return digests.size(); }
+    bool empty() const { return digests.empty(); }
+    const ConceptScalar *data(size_t i) const { return values[i]; }
+};
+
+// Digest and integrity check of concept vectors, independent of the
+// simulator. A vector passes if its digest matches and its variance (and,
+// if enabled, its largest |value|) stays below the configured thresholds.
+class SemanticVerifier
+{
+private:
+    bool enabled;
+    double varianceThreshold;
+    double maxAbsThreshold; // 0 = disabled
+    DigestAlgorithm digestAlgorithm;
+
+    bool passesThresholds(const VectorStats& stats) const;
+
+public:
+    SemanticVerifier() : enabled(true), varianceThreshold(2.0), maxAbsThreshold(0), digestAlgorithm(DigestAlgorithm::FAST) {}
+    SemanticVerifier(bool enabled, double varianceThreshold, double maxAbsThreshold, DigestAlgorithm digestAlgorithm) :
+        enabled(enabled), varianceThreshold(varianceThreshold), maxAbsThreshold(maxAbsThreshold), digestAlgorithm(digestAlgorithm) {}
+
+    SemanticDigest digest(const ConceptStorage& data) const {
+        return computeDigest(digestAlgorithm, data.data(), data.size());
+    }
+
+    // Full check; always true when verification is disabled
+    bool verify(const ConceptStorage& data, SemanticDigest expectedDigest) const;
+
+    // Statistical part of the check alone, for a digest already compared
+    bool checkStatistics(const ConceptStorage& data) const;
+
+    // verify() for every vector of batch; verdicts[i] is 1 if vector i
+    // passes. Missing fast digests are computed DIGEST_LANES vectors at a
+    // time, then statistics are checked for the vectors whose digest matched.
+    void verifyBatch(const ConceptBatch& batch, std::vector<uint8_t>& verdicts) const;
+
+    bool isEnabled() const { return enabled; }
+    DigestAlgorithm getDigestAlgorithm() const { return digestAlgorithm; }
+};
+
+#endif
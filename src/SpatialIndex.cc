@@ -0,0 +1,119 @@
+//
+// CoCoChain Spatial Neighbour Index Implementation
+//
+
+#include "SpatialIndex.h"
+#include <inet/common/ModuleAccess.h>
+#include <inet/mobility/contract/IMobility.h>
+#include <algorithm>
+
+Define_Module(SpatialIndex);
+
+SpatialIndex::SpatialIndex() :
+    numUpdates(0)
+{
+}
+
+SpatialIndex::~SpatialIndex()
+{
+    cModule *systemModule = getSimulation()->getSystemModule();
+    if (systemModule && systemModule->isSubscribed(IMobility::mobilityStateChangedSignal, this))
+        systemModule->unsubscribe(IMobility::mobilityStateChangedSignal, this);
+}
+
+void SpatialIndex::initialize(int stage)
+{
+    if (stage == INITSTAGE_LOCAL) {
+        sizeX = par("playgroundSizeX");
+        sizeY = par("playgroundSizeY");
+        int subdivision = par("cellSubdivision");
+        rows = par("gridRows").intValue() * subdivision;
+        cols = par("gridCols").intValue() * subdivision;
+        if (rows < 1 || cols < 1)
+            throw cRuntimeError("gridRows, gridCols and cellSubdivision must be positive");
+        cellWidth = sizeX / cols;
+        cellHeight = sizeY / rows;
+        cells.resize(rows * cols);
+
+        // Mobility modules announce their initial position and every move
+        // through this signal; listening at the top catches all vehicles
+        getSimulation()->getSystemModule()->subscribe(IMobility::mobilityStateChangedSignal, this);
+
+        WATCH(numUpdates);
+    }
+}
+
+void SpatialIndex::handleMessage(cMessage *)
+{
+    throw cRuntimeError("SpatialIndex does not process messages");
+}
+
+void SpatialIndex::finish()
+{
+    recordScalar("Spatial index entries", entries.size());
+    recordScalar("Spatial index updates", numUpdates);
+}
+
+int SpatialIndex::cellOf(const Coord& position) const
+{
+    int col = std::min(cols - 1, std::max(0, static_cast<int>(position.x / cellWidth)));
+    int row = std::min(rows - 1, std::max(0, static_cast<int>(position.y / cellHeight)));
+    return row * cols + col;
+}
+
+void SpatialIndex::moveEntry(int entryIndex, const Coord& position)
+{
+    Entry& entry = entries[entryIndex];
+    entry.position = position;
+    int cell = cellOf(position);
+    if (cell == entry.cell) return;
+
+    // Swap-remove from the old cell, fixing the slot of the moved entry
+    std::vector<int>& oldCell = cells[entry.cell];
+    int last = oldCell.back();
+    oldCell[entry.slot] = last;
+    entries[last].slot = entry.slot;
+    oldCell.pop_back();
+
+    entry.cell = cell;
+    entry.slot = cells[cell].size();
+    cells[cell].push_back(entryIndex);
+}
+
+void SpatialIndex::receiveSignal(cComponent *source, simsignal_t signalID, cObject *obj, cObject *)
+{
+    if (signalID != IMobility::mobilityStateChangedSignal) return;
+
+    IMobility *mobility = check_and_cast<IMobility *>(obj);
+    const Coord& position = mobility->getCurrentPosition();
+    numUpdates++;
+
+    auto entry = entryByMobility.tryEmplace(source->getId());
+    if (!entry.second) {
+        moveEntry(*entry.first, position);
+        return;
+    }
+
+    // First report from this node
+    Entry newEntry;
+    newEntry.nodeId = getContainingNode(check_and_cast<cModule *>(source))->getId();
+    newEntry.position = position;
+    newEntry.cell = cellOf(position);
+    newEntry.slot = cells[newEntry.cell].size();
+    *entry.first = entries.size();
+    cells[newEntry.cell].push_back(entries.size());
+    entries.push_back(newEntry);
+}
+
+int SpatialIndex::countInRange(const Coord& center, double range) const
+{
+    int count = 0;
+    forEachCandidate(center, range, [&](const Entry&) { count++; });
+    return count;
+}
+
+void SpatialIndex::getNodesInRange(const Coord& center, double range, std::vector<int>& nodeIds) const
+{
+    nodeIds.clear();
+    forEachCandidate(center, range, [&](const Entry& entry) { nodeIds.push_back(entry.nodeId); });
+}
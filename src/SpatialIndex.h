@@ -0,0 +1,85 @@
+//
+// CoCoChain Spatial Neighbour Index
+//
+
+#ifndef __COCOCHAIN_SPATIALINDEX_H_
+#define __COCOCHAIN_SPATIALINDEX_H_
+
+#include <omnetpp.h>
+#include <inet/common/INETDefs.h>
+#include <inet/common/geometry/common/Coord.h>
+#include <cmath>
+#include <vector>
+
+#include "FlatHashMap.h"
+
+using namespace omnetpp;
+using namespace inet;
+
+// Uniform grid over the playground holding the position of every vehicle.
+// The grid is gridRows x gridCols districts, each split into
+// cellSubdivision x cellSubdivision cells. It is kept current from
+// IMobility::mobilityStateChangedSignal: a move costs O(1), and a range
+// query visits only the cells overlapping the query circle.
+class SpatialIndex : public cSimpleModule, public cListener
+{
+private:
+    struct Entry {
+        int nodeId; // module ID of the containing network node
+        Coord position;
+        int cell;
+        int slot; // position of this entry in cells[cell]
+    };
+
+    double sizeX;
+    double sizeY;
+    int rows;
+    int cols;
+    double cellWidth;
+    double cellHeight;
+
+    std::vector<Entry> entries;
+    std::vector<std::vector<int>> cells; // entry indices per cell
+    FlatHashMap<int> entryByMobility; // mobility module ID -> entry index
+    long numUpdates;
+
+    int cellOf(const Coord& position) const;
+    void moveEntry(int entryIndex, const Coord& position);
+
+    template <typename F>
+    void forEachCandidate(const Coord& center, double range, F f) const {
+        int col0 = std::max(0, static_cast<int>(std::floor((center.x - range) / cellWidth)));
+        int col1 = std::min(cols - 1, static_cast<int>(std::floor((center.x + range) / cellWidth)));
+        int row0 = std::max(0, static_cast<int>(std::floor((center.y - range) / cellHeight)));
+        int row1 = std::min(rows - 1, static_cast<int>(std::floor((center.y + range) / cellHeight)));
+        double range2 = range * range;
+        for (int row = row0; row <= row1; row++) {
+            for (int col = col0; col <= col1; col++) {
+                for (int entryIndex : cells[row * cols + col]) {
+                    const Entry& entry = entries[entryIndex];
+                    if (entry.position.sqrdist(center) <= range2) f(entry);
+                }
+            }
+        }
+    }
+
+protected:
+    virtual int numInitStages() const override { return NUM_INIT_STAGES; }
+    virtual void initialize(int stage) override;
+    virtual void handleMessage(cMessage *msg) override;
+    virtual void finish() override;
+
+public:
+    SpatialIndex();
+    virtual ~SpatialIndex();
+
+    virtual void receiveSignal(cComponent *source, simsignal_t signalID, cObject *obj, cObject *details) override;
+
+    // Nodes within range of center, including one standing at center itself
+    int countInRange(const Coord& center, double range) const;
+    void getNodesInRange(const Coord& center, double range, std::vector<int>& nodeIds) const;
+
+    int getNumEntries() const { return static_cast<int>(entries.size()); }
+};
+
+#endif
@@ -0,0 +1,59 @@
+//
+// CoCoChain Token Bucket
+//
+
+#ifndef __COCOCHAIN_TOKENBUCKET_H_
+#define __COCOCHAIN_TOKENBUCKET_H_
+
+#include <algorithm>
+
+// Token bucket rate limiter: tokens accrue at rate per second up to burst,
+// and each send takes one. Independent of the simulator (times are passed
+// in as seconds); the rate can be changed at any time without losing the
+// tokens accrued so far.
+class TokenBucket
+{
+private:
+    double rate;
+    double burst;
+    double tokens;
+    double lastRefill;
+
+    void refill(double now) {
+        tokens = std::min(burst, tokens + (now - lastRefill) * rate);
+        lastRefill = now;
+    }
+
+public:
+    TokenBucket() : rate(0), burst(1), tokens(1), lastRefill(0) {}
+
+    // Starts with a full bucket
+    void configure(double rate, double burst, double now) {
+        this->rate = rate;
+        this->burst = std::max(1.0, burst);
+        tokens = this->burst;
+        lastRefill = now;
+    }
+
+    void setRate(double rate, double now) {
+        refill(now);
+        this->rate = rate;
+    }
+
+    bool tryTake(double now) {
+        refill(now);
+        if (tokens < 1) return false;
+        tokens -= 1;
+        return true;
+    }
+
+    // Earliest time tryTake() can succeed
+    double nextTokenAt(double now) const {
+        double available = std::min(burst, tokens + (now - lastRefill) * rate);
+        return available >= 1 ? now : now + (1 - available) / rate;
+    }
+
+    double getRate() const { return rate; }
+};
+
+#endif
@@ -0,0 +1,50 @@
+//
+// CoCoChain Transaction and Consensus Message Types
+//
+
+#ifndef __COCOCHAIN_TRANSACTION_H_
+#define __COCOCHAIN_TRANSACTION_H_
+
+#include <cstdint>
+#include <inet/networklayer/common/L3Address.h>
+
+#include "ConceptStorage.h"
+#include "SemanticDigest.h"
+
+struct ConceptVector {
+    ConceptStorage data;
+    uint64_t timestamp;
+    int nodeId;
+    bool isCorrupted;
+
+    ConceptVector() : timestamp(0), nodeId(-1), isCorrupted(false) {}
+};
+
+struct Transaction {
+    uint64_t id;
+    ConceptVector conceptVector;
+    SemanticDigest semanticDigest;
+    uint64_t timestamp;
+    int originator; // dense node index
+    inet::L3Address originatorAddress; // where votes go in "aggregated" mode
+    bool verified;
+    // Computed once on receive when the verification cache is enabled
+    bool hasVerifyCacheKey;
+    uint64_t verifyCacheKey;
+    SemanticDigest payloadFingerprint; // fast digest of the received payload
+
+    Transaction() : id(0), semanticDigest(0), timestamp(0), originator(-1), verified(false),
+                    hasVerifyCacheKey(false), verifyCacheKey(0), payloadFingerprint(0) {}
+};
+
+struct ConsensusMessage {
+    enum Type { PROPOSE, VOTE, COMMIT };
+    Type type;
+    uint64_t transactionId;
+    int senderId;
+    int senderIndex; // dense node index of the sender
+    bool vote; // true = accept, false = reject
+    uint64_t timestamp;
+};
+
+#endif
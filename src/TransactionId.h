@@ -0,0 +1,29 @@
+//
+// CoCoChain Transaction ID Scheme
+//
+
+#ifndef __COCOCHAIN_TRANSACTIONID_H_
+#define __COCOCHAIN_TRANSACTIONID_H_
+
+#include <cstdint>
+
+// Transaction IDs are unique per network: the originator's dense node
+// index (see CoCoChainRegistry) in the upper 32 bits and a per-originator
+// sequence number in the lower 32. Sequence numbers are monotone per
+// originator, which the sliding-window dedup filter relies on.
+inline uint64_t makeTransactionId(int originator, uint64_t sequence)
+{
+    return (static_cast<uint64_t>(originator) << 32) | (sequence & 0xffffffffULL);
+}
+
+inline int transactionOriginator(uint64_t txId)
+{
+    return static_cast<int>(txId >> 32);
+}
+
+inline uint64_t transactionSequence(uint64_t txId)
+{
+    return txId & 0xffffffffULL;
+}
+
+#endif
@@ -0,0 +1,93 @@
+//
+// CoCoChain Concept Vector Statistics Implementation
+//
+
+#include "VectorStats.h"
+#include <algorithm>
+#include <cmath>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#endif
+
+namespace {
+
+#if defined(__AVX2__)
+inline __m256d load4(const double *p) { return _mm256_loadu_pd(p); }
+inline __m256d load4(const float *p) { return _mm256_cvtps_pd(_mm_loadu_ps(p)); }
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+inline float64x2_t load2(const double *p) { return vld1q_f64(p); }
+inline float64x2_t load2(const float *p) { return vcvt_f64_f32(vld1_f32(p)); }
+#endif
+
+template <typename T>
+VectorStats computeStats(const T *data, size_t size)
+{
+    VectorStats stats;
+    if (size == 0) return stats;
+
+    double sum = 0, sumSquares = 0, maxAbs = 0;
+    size_t i = 0;
+
+#if defined(__AVX2__)
+    __m256d vsum = _mm256_setzero_pd();
+    __m256d vsumSquares = _mm256_setzero_pd();
+    __m256d vmaxAbs = _mm256_setzero_pd();
+    const __m256d signMask = _mm256_set1_pd(-0.0);
+    for (; i + 4 <= size; i += 4) {
+        __m256d v = load4(data + i);
+        vsum = _mm256_add_pd(vsum, v);
+        vsumSquares = _mm256_add_pd(vsumSquares, _mm256_mul_pd(v, v));
+        vmaxAbs = _mm256_max_pd(vmaxAbs, _mm256_andnot_pd(signMask, v));
+    }
+    alignas(32) double lanes[3][4];
+    _mm256_store_pd(lanes[0], vsum);
+    _mm256_store_pd(lanes[1], vsumSquares);
+    _mm256_store_pd(lanes[2], vmaxAbs);
+    for (int k = 0; k < 4; k++) {
+        sum += lanes[0][k];
+        sumSquares += lanes[1][k];
+        maxAbs = std::max(maxAbs, lanes[2][k]);
+    }
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+    float64x2_t vsum = vdupq_n_f64(0);
+    float64x2_t vsumSquares = vdupq_n_f64(0);
+    float64x2_t vmaxAbs = vdupq_n_f64(0);
+    for (; i + 2 <= size; i += 2) {
+        float64x2_t v = load2(data + i);
+        vsum = vaddq_f64(vsum, v);
+        vsumSquares = vfmaq_f64(vsumSquares, v, v);
+        vmaxAbs = vmaxq_f64(vmaxAbs, vabsq_f64(v));
+    }
+    sum = vaddvq_f64(vsum);
+    sumSquares = vaddvq_f64(vsumSquares);
+    maxAbs = vmaxvq_f64(vmaxAbs);
+#endif
+
+    // Scalar tail (or the whole vector without SIMD support)
+    for (; i < size; i++) {
+        double v = data[i];
+        sum += v;
+        sumSquares += v * v;
+        maxAbs = std::max(maxAbs, std::fabs(v));
+    }
+
+    stats.mean = sum / size;
+    stats.variance = std::max(0.0, sumSquares / size - stats.mean * stats.mean);
+    stats.maxAbs = maxAbs;
+    return stats;
+}
+
+} // namespace
+
+VectorStats computeVectorStats(const double *data, size_t size)
+{
+    return computeStats(data, size);
+}
+
+VectorStats computeVectorStats(const float *data, size_t size)
+{
+    return computeStats(data, size);
+}
@@ -0,0 +1,26 @@
+//
+// CoCoChain Concept Vector Statistics
+//
+
+#ifndef __COCOCHAIN_VECTORSTATS_H_
+#define __COCOCHAIN_VECTORSTATS_H_
+
+#include <cstddef>
+
+struct VectorStats {
+    double mean;
+    double variance; // population variance
+    double maxAbs;
+
+    VectorStats() : mean(0), variance(0), maxAbs(0) {}
+};
+
+// Mean, variance and max |x| in a single pass (sum and sum of squares).
+// Uses AVX2 or NEON when the compiler targets them, scalar code otherwise.
+// The sum-of-squares form loses precision only when |mean| >> stddev,
+// which concept vectors (zero-mean, unit scale) do not exhibit.
+// Single-precision input is accumulated in double.
+VectorStats computeVectorStats(const double *data, size_t size);
+VectorStats computeVectorStats(const float *data, size_t size);
+
+#endif
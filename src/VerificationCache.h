@@ -0,0 +1,83 @@
+//
+// CoCoChain Verification Cache
+//
+
+#ifndef __COCOCHAIN_VERIFICATIONCACHE_H_
+#define __COCOCHAIN_VERIFICATIONCACHE_H_
+
+#include <cstdint>
+#include <vector>
+
+#include "FlatHashMap.h"
+#include "SemanticDigest.h"
+
+// Direct-mapped cache of semantic verification verdicts. The key combines
+// the claimed digest with a fast fingerprint of the received payload, so a
+// verdict is only reused for the same payload claiming the same digest;
+// a tampered copy of a verified transaction misses. A colliding insert
+// simply evicts the previous entry.
+//
+// The fingerprint is a fast digest over the whole payload, so with the
+// "fast" digest algorithm a hit only saves the statistics check (the
+// fingerprint doubles as the recomputed digest on a miss). The cache pays
+// off with "sha256", where a hit skips the cryptographic digest.
+// Keying on the transaction id alone would be cheaper but would also hand a
+// tampered copy the verdict of the original.
+class VerificationCache
+{
+private:
+    struct Slot {
+        uint64_t key;
+        uint8_t state; // EMPTY, or the verdict
+    };
+    enum { INVALID = 0, VALID = 1, EMPTY = 2 };
+
+    std::vector<Slot> slots;
+    size_t mask;
+    long hits;
+    long misses;
+
+public:
+    VerificationCache() : mask(0), hits(0), misses(0) {}
+
+    // Rounds size up to a power of two and clears the cache; 0 disables it
+    void resize(size_t size) {
+        size_t capacity = 1;
+        while (capacity < size) capacity *= 2;
+        slots.assign(size ? capacity : 0, Slot{0, EMPTY});
+        mask = size ? capacity - 1 : 0;
+    }
+
+    bool isEnabled() const { return !slots.empty(); }
+
+    static uint64_t keyOf(SemanticDigest payloadFingerprint, SemanticDigest claimedDigest) {
+        return mixTransactionId(payloadFingerprint ^ mixTransactionId(claimedDigest));
+    }
+
+    // Returns the cached verdict (0 or 1), or -1 on a miss
+    int lookup(uint64_t key) {
+        const Slot& slot = slots[key & mask];
+        if (slot.state != EMPTY && slot.key == key) {
+            hits++;
+            return slot.state;
+        }
+        misses++;
+        return -1;
+    }
+
+    // Like lookup(), without counting a hit or miss
+    bool contains(uint64_t key) const {
+        const Slot& slot = slots[key & mask];
+        return slot.state != EMPTY && slot.key == key;
+    }
+
+    void insert(uint64_t key, bool verdict) {
+        slots[key & mask] = Slot{key, static_cast<uint8_t>(verdict ? VALID : INVALID)};
+    }
+
+    long getHits() const { return hits; }
+    long getMisses() const { return misses; }
+    size_t getMemoryUsage() const { return slots.capacity() * sizeof(Slot); }
+};
+
+#endif
@@ -0,0 +1,66 @@
+//
+// CoCoChain Vote Table
+//
+
+#ifndef __COCOCHAIN_VOTETABLE_H_
+#define __COCOCHAIN_VOTETABLE_H_
+
+#include <cstdint>
+#include <utility>
+
+#include "FlatHashMap.h"
+#include "ObjectPool.h"
+#include "VoteTally.h"
+
+// Pooled VoteTallies keyed by transaction ID. Independent of the simulator
+// (times are passed in as microseconds), so the tally kernel can be driven
+// by synthetic vote streams outside OMNeT++.
+class VoteTable
+{
+private:
+    ObjectPool<VoteTally> pool;
+    FlatHashMap<VoteTally*> tallies;
+
+public:
+    // Returns the tally for txId and whether it was just opened; a new
+    // tally is reset, sized for numVoters and stamped with now
+    std::pair<VoteTally*, bool> open(uint64_t txId, int numVoters, uint64_t now) {
+        auto entry = tallies.tryEmplace(txId);
+        if (entry.second) {
+            VoteTally *tally = pool.acquire();
+            tally->reset();
+            tally->reserveVoters(numVoters);
+            tally->setOpenedAt(now);
+            *entry.first = tally;
+        }
+        return {*entry.first, entry.second};
+    }
+
+    VoteTally *find(uint64_t txId) {
+        VoteTally **tally = tallies.find(txId);
+        return tally ? *tally : nullptr;
+    }
+
+    void drop(uint64_t txId) {
+        if (VoteTally **tally = tallies.find(txId)) {
+            pool.release(*tally);
+            tallies.erase(txId);
+        }
+    }
+
+    // Drops tallies opened before cutoff
+    size_t expire(uint64_t cutoff) {
+        return tallies.eraseIf([&](uint64_t, VoteTally *tally) {
+            if (tally->getOpenedAt() >= cutoff) return false;
+            pool.release(tally);
+            return true;
+        });
+    }
+
+    void reserve(size_t expectedLive) { tallies.reserve(expectedLive); }
+    size_t size() const { return tallies.size(); }
+    // Pool blocks allocated and table rehashes so far (tally bitsets not included)
+    size_t getAllocationCount() const { return pool.getAllocationCount() + tallies.getRehashCount(); }
+};
+
+#endif
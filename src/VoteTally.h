@@ -0,0 +1,79 @@
+//
+// CoCoChain Vote Tally
+//
+
+#ifndef __COCOCHAIN_VOTETALLY_H_
+#define __COCOCHAIN_VOTETALLY_H_
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+// Running accept/reject counters for one transaction. Voters are tracked in
+// a bitset indexed by dense node index, so each vote costs O(1) and repeated
+// votes from the same node are ignored.
+class VoteTally
+{
+private:
+    uint32_t acceptVotes;
+    uint32_t rejectVotes;
+    uint64_t openedAt; // time of the first vote (us), used for ageing
+    int requiredVotes; // quorum, snapshotted from the neighbour table
+    bool local; // we originated the transaction
+    std::vector<uint64_t> voters;
+
+public:
+    VoteTally() : acceptVotes(0), rejectVotes(0), openedAt(0), requiredVotes(1), local(false) {}
+
+    // Clears the tally for reuse, keeping the bitset storage
+    void reset() {
+        acceptVotes = rejectVotes = 0;
+        openedAt = 0;
+        requiredVotes = 1;
+        local = false;
+        std::fill(voters.begin(), voters.end(), 0);
+    }
+
+    // Presizes the bitset for voter indices below numVoters
+    void reserveVoters(int numVoters) {
+        size_t words = (static_cast<size_t>(numVoters) + 63) / 64;
+        if (voters.size() < words) voters.resize(words, 0);
+    }
+
+    // Returns false if the voter has already been counted
+    bool addVote(int voterIndex, bool accept) {
+        size_t word = static_cast<size_t>(voterIndex) / 64;
+        uint64_t mask = 1ULL << (voterIndex % 64);
+        if (word >= voters.size()) {
+            voters.resize(word + 1, 0);
+        }
+        else if (voters[word] & mask) {
+            return false;
+        }
+        voters[word] |= mask;
+        if (accept) acceptVotes++; else rejectVotes++;
+        return true;
+    }
+
+    bool hasVoted(int voterIndex) const {
+        size_t word = static_cast<size_t>(voterIndex) / 64;
+        return word < voters.size() && (voters[word] & (1ULL << (voterIndex % 64)));
+    }
+
+    // Voter bitset, bit i of word i / 64 set if node i has voted
+    const std::vector<uint64_t>& getVoters() const { return voters; }
+
+    void setOpenedAt(uint64_t time) { openedAt = time; }
+    uint64_t getOpenedAt() const { return openedAt; }
+    void setLocal(bool isLocal) { local = isLocal; }
+    bool isLocal() const { return local; }
+    void setRequiredVotes(int votes) { requiredVotes = votes; }
+    int getRequiredVotes() const { return requiredVotes; }
+
+    int getAcceptVotes() const { return acceptVotes; }
+    int getRejectVotes() const { return rejectVotes; }
+    int getTotalVotes() const { return acceptVotes + rejectVotes; }
+    bool hasQuorum() const { return getTotalVotes() >= requiredVotes; }
+};
+
+#endif